@@ -0,0 +1,163 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <ymir/CallularAutomata.hpp>
+#include <ymir/Map.hpp>
+#include <ymir/Noise.hpp>
+#include <ymir/Utility.h>
+
+namespace {
+
+struct PlacedRoom {
+  ymir::Map<char> M;
+  ymir::Point2d<int> Pos;
+};
+
+std::vector<PlacedRoom> generateRooms(ymir::Size2d<int> MapSize,
+                                      std::size_t NumRooms) {
+  std::mt19937 RndEng(42);
+  std::uniform_int_distribution<int> RoomSize(5, 24);
+  std::vector<PlacedRoom> Rooms;
+  for (std::size_t Idx = 0; Idx < NumRooms; Idx++) {
+    ymir::Map<char> M(RoomSize(RndEng), RoomSize(RndEng));
+    M.fill('#');
+    M.fillRect(' ', ymir::Rect2d<int>{{1, 1}, {M.getSize().W - 2,
+                                               M.getSize().H - 2}});
+    std::uniform_int_distribution<int> PosX(0, MapSize.W - M.getSize().W);
+    std::uniform_int_distribution<int> PosY(0, MapSize.H - M.getSize().H);
+    ymir::Point2d<int> Pos{PosX(RndEng), PosY(RndEng)};
+    Rooms.push_back({std::move(M), Pos});
+  }
+  return Rooms;
+}
+
+/// Double-buffered tile by tile replace rule as a reference for the
+/// synchronous cellular automaton
+void replaceByTile(ymir::Map<char> &M, char Target, char Replace,
+                   std::size_t Thres) {
+  const auto Prev = M;
+  M.forEach([&Prev, Target, Replace, Thres](auto P, char &Tile) {
+    if (Tile == Target && Prev.getNeighborCount(P, Target) < Thres) {
+      Tile = Replace;
+    }
+  });
+}
+
+/// Tile by tile merge as a reference for the row-wise Map::merge
+void mergeByTile(ymir::Map<char> &M, const ymir::Map<char> &Other,
+                 ymir::Point2d<int> Pos) {
+  Other.forEach([&M, &Pos](auto P, char Tile) {
+    if (M.contains(P + Pos)) {
+      M.getTile(P + Pos) = Tile;
+    }
+  });
+}
+
+void report(const std::string &Name, double RefMs, double Ms) {
+  std::cout << Name << ": tile by tile " << RefMs << " ms, map " << Ms
+            << " ms, speedup " << (Ms > 0 ? RefMs / Ms : 0) << "x"
+            << std::endl;
+}
+
+} // namespace
+
+int main(int Argc, char *Argv[]) {
+  std::size_t Iterations = 200;
+  if (Argc == 2) {
+    Iterations = std::stoul(Argv[1]);
+  }
+#ifndef NDEBUG
+  // Unoptimized tile by tile loops are slowed down far more than the memset
+  // and memcpy paths, which would inflate the speedups
+  std::cerr << "warning: debug build, use Release or RelWithDebInfo for "
+               "meaningful timings"
+            << std::endl;
+#endif
+
+  // Merge loop as done by the room placer for each generated dungeon
+  const ymir::Size2d<int> MapSize{200, 100};
+  const auto Rooms = generateRooms(MapSize, 64);
+  ymir::Map<char> Ref(MapSize), Fast(MapSize);
+  auto RefMs = ymir::measureRuntime([&]() {
+    for (std::size_t It = 0; It < Iterations; It++) {
+      for (const auto &Room : Rooms) {
+        mergeByTile(Ref, Room.M, Room.Pos);
+      }
+    }
+  });
+  auto Ms = ymir::measureRuntime([&]() {
+    for (std::size_t It = 0; It < Iterations; It++) {
+      for (const auto &Room : Rooms) {
+        Fast.merge(Room.M, Room.Pos);
+      }
+    }
+  });
+  report("merge rooms", RefMs, Ms);
+
+  // Hallway and background fills
+  const ymir::Rect2d<int> FillRect{{3, 2}, {150, 80}};
+  RefMs = ymir::measureRuntime([&]() {
+    for (std::size_t It = 0; It < Iterations * 10; It++) {
+      Ref.forEachElem([It](char &Tile) { Tile = char('a' + It % 2); },
+                      FillRect);
+    }
+  });
+  Ms = ymir::measureRuntime([&]() {
+    for (std::size_t It = 0; It < Iterations * 10; It++) {
+      Fast.fillRect(char('a' + It % 2), FillRect);
+    }
+  });
+  report("fill rect", RefMs, Ms);
+
+  // Comparison of equal maps, e.g. when checking for a fixed point. Both maps
+  // change a tile each iteration, the comparison can not be hoisted out of the
+  // loop then.
+  bool RefEqual = true, Equal = true;
+  const auto changeTile = [&Ref, &Fast, &MapSize](std::size_t It) {
+    const ymir::Point2d<int> P{int(It % MapSize.W),
+                               int(It / MapSize.W % MapSize.H)};
+    Ref.setTile(P, char('a' + It % 3));
+    Fast.setTile(P, char('a' + It % 3));
+  };
+  RefMs = ymir::measureRuntime([&]() {
+    for (std::size_t It = 0; It < Iterations * 10; It++) {
+      changeTile(It);
+      Ref.forEach([&RefEqual, &Fast](auto P, char Tile) {
+        RefEqual &= Fast.getTile(P) == Tile;
+      });
+    }
+  });
+  Ms = ymir::measureRuntime([&]() {
+    for (std::size_t It = 0; It < Iterations * 10; It++) {
+      changeTile(It);
+      Equal &= Ref == Fast;
+    }
+  });
+  report("compare", RefMs, Ms);
+
+  // Cave generation on a large map
+  ymir::Map<char> CaveRef(1024, 1024);
+  CaveRef.fill('#');
+  std::mt19937 RndEng(42);
+  ymir::fillRectRandom(CaveRef, ' ', 0.55f, RndEng);
+  auto Cave = CaveRef;
+  const std::size_t Generations = 10;
+  RefMs = ymir::measureRuntime([&]() {
+    for (std::size_t It = 0; It < Generations; It++) {
+      replaceByTile(CaveRef, ' ', '#', 4);
+    }
+  });
+  Ms = ymir::measureRuntime([&]() {
+    ymir::celat::Automaton<int> CA;
+    CA.replace(Cave, ' ', '#', 4, Generations);
+  });
+  report("cellular automaton", RefMs, Ms);
+  Equal &= Cave == CaveRef;
+
+  if (!RefEqual || !Equal) {
+    std::cerr << "Maps differ" << std::endl;
+    return 1;
+  }
+  return 0;
+}
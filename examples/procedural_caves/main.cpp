@@ -1,33 +1,52 @@
 #include <cmath>
+#include <functional>
 #include <iostream>
 #include <unistd.h>
+#include <vector>
 #include <ymir/CallularAutomata.hpp>
+#include <ymir/ChunkedMap.hpp>
 #include <ymir/Map.hpp>
+#include <ymir/MarginChunkGenerator.hpp>
 #include <ymir/Noise.hpp>
 
-template <typename TileType, typename U, typename RE>
-void generate_caves(ymir::Map<TileType, U> &M, TileType Ground, TileType Wall,
-                    ymir::Point2d<U> Offset, RE RandEng) {
+template <typename TileType, typename U>
+void generate_base(ymir::Map<TileType, U> &M, TileType Ground, TileType Wall,
+                   ymir::Point2d<U> Offset, const ymir::CoordHash &Hash) {
   // Make entire map walls
   M.fillRect(Wall);
 
-  // Generate initial ground tiles
+  // Generate initial ground tiles, seeded from the world position
   const float GroundChance = 0.65f;
-  ymir::fillRectSeedRandom(M, Ground, GroundChance, RandEng,
-                           ymir::Rect2d<U>{{0, 0}, {0, 0}}, Offset);
+  ymir::fillRectCoordRandom(M, Ground, GroundChance, Hash, {}, Offset);
+}
+
+// Returns the cellular automaton generations, each one only reads the
+// neighbors of a tile and needs a margin of one tile around the chunk
+template <typename TileType, typename U>
+std::vector<std::function<void(ymir::Map<TileType, U> &)>>
+get_cave_generations(TileType Ground, TileType Wall) {
+  // Synchronous generations only depend on the neighborhood of a tile, in
+  // place updates would not line up across chunk borders
+  using MapType = ymir::Map<TileType, U>;
 
   // Run replacement
   const std::size_t ReplaceThres = 4, Iterations = 6;
-  for (std::size_t Idx = 0; Idx < Iterations; Idx++) {
-    ymir::celat::replace(M, Ground, Wall, ReplaceThres);
-  }
+  std::vector<std::function<void(MapType &)>> Generations(
+      Iterations, [Ground, Wall, ReplaceThres](MapType &M) {
+        ymir::celat::Automaton<U>().replace(M, Ground, Wall, ReplaceThres);
+      });
 
   // Smooth generation
   const std::size_t SmoothThres = 5;
-  ymir::celat::generate(M, Ground, SmoothThres);
+  Generations.emplace_back([Ground, SmoothThres](MapType &M) {
+    ymir::celat::Automaton<U>().generate(M, Ground, SmoothThres);
+  });
 
   // Kill isolated ground
-  ymir::celat::generate(M, Wall, 8);
+  Generations.emplace_back([Wall](MapType &M) {
+    ymir::celat::Automaton<U>().generate(M, Wall, 8);
+  });
+  return Generations;
 }
 
 constexpr float deg2rad(float Degree) { return Degree / 360 * 2 * M_PI; }
@@ -38,17 +57,23 @@ int main(int Argc, char *Argv[]) {
     OffsetX = std::stoi(Argv[1]);
     OffsetY = std::stoi(Argv[2]);
   }
-  ymir::Map<char> Map(80, 24);
-  ymir::WyHashRndEng RE;
-  RE.seed(std::random_device()());
+  const ymir::CoordHash Hash{std::random_device()()};
+
+  // Chunks are generated once on first sight and reused while they are hot,
+  // the caves continue seamlessly across the chunk borders
+  ymir::MarginChunkGenerator<char> Generator(
+      {32, 32},
+      [&Hash](ymir::Map<char> &Chunk, ymir::Point2d<int> Origin) {
+        generate_base(Chunk, ' ', '#', Origin, Hash);
+      },
+      get_cave_generations<char, int>(' ', '#'));
+  ymir::ChunkedMap<char> World({32, 32}, std::ref(Generator));
 
   for (float Degree = 0; Degree < 360; Degree += 1.0) {
     int PosY = sin(deg2rad(Degree)) * 50;
     int PosX = cos(deg2rad(Degree)) * 50;
-    generate_caves(Map, ' ', '#', {OffsetX + PosX, OffsetY + PosY}, RE);
-    (void)(PosX + OffsetX);
-    (void)(PosY + OffsetY);
-    std::cout << "\e[1;1H\e[2J" << Map;
+    std::cout << "\e[1;1H\e[2J"
+              << World.copyRect({{OffsetX + PosX, OffsetY + PosY}, {80, 24}});
     usleep(100 * 1000);
   }
 }
@@ -1,9 +1,12 @@
 #ifndef YMIR_ALGORITHM_DIJKSTRA_HPP
 #define YMIR_ALGORITHM_DIJKSTRA_HPP
 
+#include <algorithm>
 #include <limits>
 #include <queue>
+#include <stdexcept>
 #include <tuple>
+#include <vector>
 #include <ymir/Map.hpp>
 #include <ymir/Types.hpp>
 
@@ -19,38 +22,75 @@ auto getDijkstraQueue(const std::vector<ymir::Point2d<TileCord>> &Starts) {
   return Q;
 }
 
-template <typename TileCord, typename UnaryPred,
+/// Throws std::out_of_range if any of the start positions is outside of DM
+template <typename DistMapType, typename TileCord>
+void checkDijkstraStarts(const DistMapType &DM,
+                         const std::vector<ymir::Point2d<TileCord>> &Starts) {
+  for (const auto &Start : Starts) {
+    if (!DM.contains(Start)) {
+      throw std::out_of_range("Dijkstra map start outside of map");
+    }
+  }
+}
+
+/// Computes the dijkstra map into DM, which can be any int map type (e.g.
+/// ymir::Map or ymir::MapView), positions are relative to DM
+///
+/// Every step costs one, the tiles are visited breadth first from a FIFO
+/// queue one distance after the other. The result is the same as the one of
+/// a priority queue ordered by distance and position.
+template <typename DistMapType, typename TileCord, typename UnaryPred,
           typename DirectionProvider = FourTileDirections<TileCord>>
-ymir::Map<int, TileCord> getDijkstraMap(
-    ymir::Size2d<TileCord> MapSize,
-    const std::vector<ymir::Point2d<TileCord>> &Starts, UnaryPred IsBlocked,
+void fillDijkstraMap(
+    DistMapType &DM, const std::vector<ymir::Point2d<TileCord>> &Starts,
+    UnaryPred IsBlocked,
     [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) {
-  ymir::Map<int, TileCord> DM(MapSize);
+  checkDijkstraStarts(DM, Starts);
 
   // Mark the entire map as unvisited
   DM.fill(-1);
 
-  auto Queue = getDijkstraQueue(Starts);
+  // Starts are taken in the order of their positions, a start next to an
+  // earlier one is queued again and ends up with a distance of one
+  std::vector<ymir::Point2d<TileCord>> Queue = Starts;
+  std::stable_sort(Queue.begin(), Queue.end(),
+                   [](const auto &A, const auto &B) {
+                     return std::tie(A.X, A.Y) < std::tie(B.X, B.Y);
+                   });
+  const auto Size = DM.getSize();
+  Queue.reserve(Queue.size() + std::size_t(Size.W) * std::size_t(Size.H));
 
-  while (!Queue.empty()) {
-    auto [Dist, PosX, PosY] = Queue.top();
-    ymir::Point2d<TileCord> Pos(PosX, PosY);
-    Queue.pop();
-    DM.setTile(Pos, Dist);
+  // Queue[Head, DistEnd) holds the positions at distance Dist
+  std::size_t Head = 0, DistEnd = Queue.size();
+  for (int Dist = 0; Head < Queue.size(); Dist++, DistEnd = Queue.size()) {
+    for (; Head < DistEnd; Head++) {
+      const auto Pos = Queue[Head];
+      DM.setTileUnchecked(Pos, Dist);
 
-    // Queue everything that is not blocked and not yet visited in reach of the
-    // current position
-    int NextDist = Dist + 1;
-    auto QueuePos = [&Queue, &IsBlocked, NextDist](auto Pos, auto &Tile) {
-      if (IsBlocked(Pos) || Tile != -1) {
+      // Queue everything that is not blocked and not yet visited in reach of
+      // the current position
+      const int NextDist = Dist + 1;
+      auto QueuePos = [&Queue, &IsBlocked, NextDist](auto Pos, auto &Tile) {
+        if (IsBlocked(Pos) || Tile != -1) {
+          return true;
+        }
+        Tile = NextDist;
+        Queue.push_back(Pos);
         return true;
-      }
-      Tile = NextDist;
-      Queue.push({NextDist, Pos.X, Pos.Y});
-      return true;
-    };
-    DirectionProvider::forEach(DM, Pos, QueuePos);
+      };
+      DirectionProvider::forEach(DM, Pos, QueuePos);
+    }
   }
+}
+
+template <typename TileCord, typename UnaryPred,
+          typename DirectionProvider = FourTileDirections<TileCord>>
+ymir::Map<int, TileCord> getDijkstraMap(
+    ymir::Size2d<TileCord> MapSize,
+    const std::vector<ymir::Point2d<TileCord>> &Starts, UnaryPred IsBlocked,
+    DirectionProvider DirProv = DirectionProvider()) {
+  ymir::Map<int, TileCord> DM(MapSize);
+  fillDijkstraMap(DM, Starts, IsBlocked, DirProv);
   return DM;
 }
 
@@ -64,12 +104,81 @@ getDijkstraMap(ymir::Size2d<TileCord> MapSize, ymir::Point2d<TileCord> Start,
       MapSize, std::vector{Start}, IsBlocked, DirProv);
 }
 
+/// Computes the dijkstra map for small integer step costs into DM, entering
+/// the tile at P costs Cost(P) and tiles with a negative cost are blocked.
+/// Costs must not exceed MaxCost, the tiles are queued in a bucket queue
+/// (Dial's algorithm) with one bucket per distance modulo MaxCost + 1.
+template <typename DistMapType, typename TileCord, typename CostFunc,
+          typename DirectionProvider = FourTileDirections<TileCord>>
+void fillWeightedDijkstraMap(
+    DistMapType &DM, const std::vector<ymir::Point2d<TileCord>> &Starts,
+    CostFunc Cost, int MaxCost,
+    [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) {
+  if (MaxCost < 0) {
+    throw std::out_of_range("Invalid maximum cost for dijkstra map");
+  }
+  checkDijkstraStarts(DM, Starts);
+  DM.fill(-1);
+
+  std::vector<std::vector<ymir::Point2d<TileCord>>> Buckets(MaxCost + 1);
+  for (const auto &Start : Starts) {
+    if (DM.getTileUnchecked(Start) != 0) {
+      DM.setTileUnchecked(Start, 0);
+      Buckets[0].push_back(Start);
+    }
+  }
+
+  std::size_t Pending = Buckets[0].size();
+  for (int Dist = 0; Pending > 0; Dist++) {
+    auto &Bucket = Buckets[Dist % Buckets.size()];
+    // Steps without cost add to the current bucket while it is processed
+    for (std::size_t Idx = 0; Idx < Bucket.size(); Idx++) {
+      const auto Pos = Bucket[Idx];
+      // Skip tiles that were reached on a shorter path after being queued
+      if (DM.getTileUnchecked(Pos) != Dist) {
+        continue;
+      }
+      auto QueuePos = [&Buckets, &Cost, &Pending, Dist, MaxCost](auto Pos,
+                                                                 auto &Tile) {
+        const int StepCost = Cost(Pos);
+        if (StepCost < 0) {
+          return true;
+        }
+        if (StepCost > MaxCost) {
+          throw std::out_of_range("Step cost exceeds the maximum cost");
+        }
+        const int NextDist = Dist + StepCost;
+        if (Tile == -1 || NextDist < Tile) {
+          Tile = NextDist;
+          Buckets[NextDist % Buckets.size()].push_back(Pos);
+          Pending++;
+        }
+        return true;
+      };
+      DirectionProvider::forEach(DM, Pos, QueuePos);
+    }
+    Pending -= Bucket.size();
+    Bucket.clear();
+  }
+}
+
+template <typename TileCord, typename CostFunc,
+          typename DirectionProvider = FourTileDirections<TileCord>>
+ymir::Map<int, TileCord> getWeightedDijkstraMap(
+    ymir::Size2d<TileCord> MapSize,
+    const std::vector<ymir::Point2d<TileCord>> &Starts, CostFunc Cost,
+    int MaxCost, DirectionProvider DirProv = DirectionProvider()) {
+  ymir::Map<int, TileCord> DM(MapSize);
+  fillWeightedDijkstraMap(DM, Starts, Cost, MaxCost, DirProv);
+  return DM;
+}
+
 // Returns a path from a dijkstra map, starting at End finds path towards Start
 // for which dijkstra map was created.
-template <typename TileCord,
+template <typename DistMapType, typename TileCord,
           typename DirectionProvider = FourTileDirections<TileCord>>
 std::vector<ymir::Point2d<TileCord>>
-getPathFromDijkstraMap(const ymir::Map<int, TileCord> &DM,
+getPathFromDijkstraMap(const DistMapType &DM,
                        const ymir::Point2d<TileCord> &Start,
                        const ymir::Point2d<TileCord> &End,
                        DirectionProvider DirProv = DirectionProvider(),
@@ -2,6 +2,7 @@
 #define YMIR_ALGORITHM_DIJKSTRA_IO_HPP
 
 #include <ymir/Algorithm/Dijkstra.hpp>
+#include <ymir/MapView.hpp>
 #include <ymir/Terminal.hpp>
 
 namespace ymir::Algorithm {
@@ -26,6 +27,12 @@ ymir::Map<ColoredUniChar, int> makeHeatMap(const ymir::Map<T, U> &Map,
   return HM;
 }
 
+/// Marks the path with its start and end in place, e.g. on a heat map
+void markPath(ymir::MapView<ymir::ColoredUniChar, int> PM,
+              ymir::Point2d<int> Start, ymir::Point2d<int> End,
+              const std::vector<ymir::Point2d<int>> &Path);
+
+/// Returns a colored copy of the map with the path marked on it
 ymir::Map<ymir::ColoredUniChar, int>
 markPath(const ymir::Map<char, int> &Map, ymir::Point2d<int> Start,
          ymir::Point2d<int> End, const std::vector<ymir::Point2d<int>> &Path);
@@ -0,0 +1,447 @@
+#ifndef YMIR_BIT_MAP_HPP
+#define YMIR_BIT_MAP_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include <ymir/Map.hpp>
+#include <ymir/Types.hpp>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ymir {
+
+inline unsigned popCount(Uint64 Word) {
+#ifdef _MSC_VER
+  return static_cast<unsigned>(__popcnt64(Word));
+#else
+  return static_cast<unsigned>(__builtin_popcountll(Word));
+#endif
+}
+
+/// Bit-packed map of boolean tiles. Each row is stored as a sequence of 64 bit
+/// words, tile X of a row is bit X % 64 of word X / 64. Unused bits of the last
+/// word of a row are always zero, this allows to run the bitwise operations on
+/// whole words, i.e. 64 tiles at once.
+template <typename U = int> class BitMap {
+public:
+  using TileType = bool;
+  using TileCord = U;
+  using TilePos = Point2d<TileCord>;
+  using WordType = Uint64;
+  using DataType = std::vector<WordType>;
+
+  static constexpr TileCord WordBits = 64;
+
+public:
+  BitMap() = default;
+
+  explicit BitMap(Size2d<TileCord> Size, bool Value = false) {
+    resize(Size, Value);
+  }
+
+  BitMap(TileCord Width, TileCord Height, bool Value = false)
+      : BitMap(Size2d<TileCord>{Width, Height}, Value) {}
+
+  /// Creates bit map from a map, a tile is set if Pred(Tile) is true
+  template <typename T, typename A, typename UnaryPred>
+  static BitMap fromMap(const Map<T, TileCord, A> &M, UnaryPred Pred) {
+    BitMap BM(M.getSize());
+    for (TileCord PY = 0; PY < BM.Size.H; PY++) {
+      auto *Words = BM.rowWords(PY);
+      if constexpr (Map<T, TileCord, A>::HasContiguousTiles) {
+        const auto *Row = M.row(PY);
+        for (TileCord PX = 0; PX < BM.Size.W; PX++) {
+          Words[PX / WordBits] |= WordType(Pred(Row[PX]) ? 1 : 0)
+                                  << (PX % WordBits);
+        }
+      } else {
+        for (TileCord PX = 0; PX < BM.Size.W; PX++) {
+          Words[PX / WordBits] |=
+              WordType(Pred(M.getTileUnchecked({PX, PY})) ? 1 : 0)
+              << (PX % WordBits);
+        }
+      }
+    }
+    return BM;
+  }
+
+  /// Creates bit map from a map, a tile is set if it is equal to Tile
+  template <typename T, typename A>
+  static BitMap fromMap(const Map<T, TileCord, A> &M, const T &Tile) {
+    return fromMap(M, [&Tile](const T &MT) { return MT == Tile; });
+  }
+
+  /// Converts the bit map to a map using SetTile for set and UnsetTile for
+  /// unset tiles
+  template <typename T> Map<T, TileCord> toMap(T SetTile, T UnsetTile) const {
+    Map<T, TileCord> M(Size);
+    for (TileCord PY = 0; PY < Size.H; PY++) {
+      const auto *Words = rowWords(PY);
+      if constexpr (Map<T, TileCord>::HasContiguousTiles) {
+        auto *Row = M.row(PY);
+        for (TileCord PX = 0; PX < Size.W; PX++) {
+          Row[PX] = (Words[PX / WordBits] >> (PX % WordBits)) & 1 ? SetTile
+                                                                   : UnsetTile;
+        }
+      } else {
+        for (TileCord PX = 0; PX < Size.W; PX++) {
+          const bool Set = (Words[PX / WordBits] >> (PX % WordBits)) & 1;
+          M.setTileUnchecked({PX, PY}, Set ? SetTile : UnsetTile);
+        }
+      }
+    }
+    return M;
+  }
+
+  Size2d<TileCord> getSize() const { return Size; }
+
+  bool empty() const { return Data.empty(); }
+
+  void resize(Size2d<TileCord> Size, bool Value = false) {
+    this->Size = Size;
+    WordsPerRow = (Size.W + WordBits - 1) / WordBits;
+    Data.assign(WordsPerRow * Size.H, 0);
+    if (Value) {
+      fill(true);
+    }
+  }
+
+  /// Returns the number of words used per row
+  std::size_t getWordsPerRow() const { return WordsPerRow; }
+
+  inline constexpr Rect2d<TileCord> rect() const {
+    return Rect2d<TileCord>{{0, 0}, Size};
+  }
+
+  inline constexpr bool contains(TilePos P) const { return rect().contains(P); }
+
+  Rect2d<TileCord>
+  getContained(std::optional<Rect2d<TileCord>> Rect = {}) const {
+    if (Rect) {
+      return rect() & *Rect;
+    }
+    return rect();
+  }
+
+  inline bool getTile(TilePos P) const {
+    if (!contains(P)) {
+      throw std::out_of_range("Position outside of bit map");
+    }
+    return getTileUnchecked(P);
+  }
+
+  inline bool getTileUnchecked(TilePos P) const {
+    assert(contains(P) && "Position outside of bit map");
+    return (word(P) >> (P.X % WordBits)) & 1;
+  }
+
+  inline void setTile(TilePos P, bool Tile) {
+    if (!contains(P)) {
+      throw std::out_of_range("Position outside of bit map");
+    }
+    setTileUnchecked(P, Tile);
+  }
+
+  inline void setTileUnchecked(TilePos P, bool Tile) {
+    assert(contains(P) && "Position outside of bit map");
+    const auto Bit = WordType(1) << (P.X % WordBits);
+    auto &Word = word(P);
+    Word = Tile ? (Word | Bit) : (Word & ~Bit);
+  }
+
+  void setTiles(const std::vector<TilePos> &Positions, bool Tile) {
+    for (auto const &Pos : Positions) {
+      setTile(Pos, Tile);
+    }
+  }
+
+  inline bool isTile(TilePos P, bool Tile) const {
+    return contains(P) && getTileUnchecked(P) == Tile;
+  }
+
+  template <typename DirectionProvider = EightTileDirections<TileCord>>
+  std::size_t getNeighborCount(
+      TilePos P, bool Tile,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) const {
+    std::size_t Count = 0;
+    for (const auto &Dir : DirectionProvider::get()) {
+      Count += isTile(P + Dir, Tile);
+    }
+    return Count;
+  }
+
+  template <typename DirectionProvider = EightTileDirections<TileCord>>
+  std::size_t getNotNeighborCount(
+      TilePos P, bool Tile,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) const {
+    return getNeighborCount(P, !Tile, DirProv);
+  }
+
+  /// Calls Func(bool) for each tile in the rect
+  template <typename UnaryFunction>
+  void forEachElem(UnaryFunction Func,
+                   std::optional<Rect2d<TileCord>> Rect = {}) const {
+    forEach([&Func](TilePos, bool Tile) { Func(Tile); }, Rect);
+  }
+
+  /// Calls Func(bool &) for each tile in the rect, changes to the tile are
+  /// written back
+  template <typename UnaryFunction>
+  void forEachElem(UnaryFunction Func,
+                   std::optional<Rect2d<TileCord>> Rect = {}) {
+    forEach([&Func](TilePos, bool &Tile) { Func(Tile); }, Rect);
+  }
+
+  /// Calls Func(TilePos, bool) for each tile in the rect
+  template <typename BinaryFunction>
+  void forEach(BinaryFunction Func,
+               std::optional<Rect2d<TileCord>> Rect = {}) const {
+    auto R = getContained(Rect);
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      const auto *Words = rowWords(PY);
+      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W; PX++) {
+        const bool Tile = (Words[PX / WordBits] >> (PX % WordBits)) & 1;
+        Func(TilePos{PX, PY}, Tile);
+      }
+    }
+  }
+
+  /// Calls Func(TilePos, bool &) for each tile in the rect, changes to the tile
+  /// are written back
+  template <typename BinaryFunction>
+  void forEach(BinaryFunction Func, std::optional<Rect2d<TileCord>> Rect = {}) {
+    auto R = getContained(Rect);
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      auto *Words = rowWords(PY);
+      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W; PX++) {
+        auto &Word = Words[PX / WordBits];
+        const auto Bit = WordType(1) << (PX % WordBits);
+        bool Tile = Word & Bit;
+        Func(TilePos{PX, PY}, Tile);
+        Word = Tile ? (Word | Bit) : (Word & ~Bit);
+      }
+    }
+  }
+
+  void fill(bool Tile) {
+    std::fill(Data.begin(), Data.end(), Tile ? ~WordType(0) : WordType(0));
+    if (Tile) {
+      clearPadding();
+    }
+  }
+
+  void fillRect(bool Tile, std::optional<Rect2d<TileCord>> Rect = {}) {
+    auto R = getContained(Rect);
+    if (R.empty()) {
+      return;
+    }
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      auto *Words = rowWords(PY);
+      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W;) {
+        // Mask of bits [PX, min(word end, rect end)) in the current word
+        const auto Bit = PX % WordBits;
+        const auto NumBits = std::min<TileCord>(WordBits - Bit,
+                                                R.Pos.X + R.Size.W - PX);
+        const auto Mask = (NumBits == WordBits ? ~WordType(0)
+                                               : ((WordType(1) << NumBits) - 1))
+                          << Bit;
+        auto &Word = Words[PX / WordBits];
+        Word = Tile ? (Word | Mask) : (Word & ~Mask);
+        PX += NumBits;
+      }
+    }
+  }
+
+  /// Returns the number of set tiles
+  std::size_t count() const {
+    std::size_t Count = 0;
+    for (const auto Word : Data) {
+      Count += popCount(Word);
+    }
+    return Count;
+  }
+
+  std::vector<TilePos> findTiles(bool Target = true) const {
+    std::vector<TilePos> Result;
+    forEach([&Target, &Result](auto Pos, bool Tile) {
+      if (Target == Tile) {
+        Result.push_back(Pos);
+      }
+    });
+    return Result;
+  }
+
+  BitMap &operator&=(const BitMap &Other) {
+    assert(Size == Other.Size && "Bit map size mismatch");
+    for (std::size_t Idx = 0; Idx < Data.size(); Idx++) {
+      Data[Idx] &= Other.Data[Idx];
+    }
+    return *this;
+  }
+
+  BitMap &operator|=(const BitMap &Other) {
+    assert(Size == Other.Size && "Bit map size mismatch");
+    for (std::size_t Idx = 0; Idx < Data.size(); Idx++) {
+      Data[Idx] |= Other.Data[Idx];
+    }
+    return *this;
+  }
+
+  BitMap &operator^=(const BitMap &Other) {
+    assert(Size == Other.Size && "Bit map size mismatch");
+    for (std::size_t Idx = 0; Idx < Data.size(); Idx++) {
+      Data[Idx] ^= Other.Data[Idx];
+    }
+    return *this;
+  }
+
+  /// Inverts all tiles
+  BitMap &flip() {
+    for (auto &Word : Data) {
+      Word = ~Word;
+    }
+    clearPadding();
+    return *this;
+  }
+
+  /// Returns a bit map in which each tile P has the value of the tile at
+  /// P + Offset in this map, tiles outside of the map read as unset. For
+  /// example shifted({1, 0}) has a tile set if its right neighbor is set.
+  BitMap shifted(TilePos Offset) const {
+    BitMap Result(Size);
+    if (std::abs(Offset.X) >= Size.W || std::abs(Offset.Y) >= Size.H) {
+      return Result;
+    }
+    const auto WordShift = std::abs(Offset.X) / WordBits;
+    const auto BitShift = std::abs(Offset.X) % WordBits;
+    const auto NumWords = static_cast<TileCord>(WordsPerRow);
+    for (TileCord PY = 0; PY < Size.H; PY++) {
+      const auto SrcY = PY + Offset.Y;
+      if (SrcY < 0 || SrcY >= Size.H) {
+        continue;
+      }
+      const auto *Src = rowWords(SrcY);
+      auto *Dst = Result.rowWords(PY);
+      for (TileCord Idx = 0; Idx < NumWords; Idx++) {
+        if (Offset.X >= 0) {
+          // Dst bit X = Src bit X + Offset.X
+          const auto Lo = Idx + WordShift;
+          const auto Hi = Lo + 1;
+          WordType Word = Lo < NumWords ? Src[Lo] >> BitShift : 0;
+          if (BitShift != 0 && Hi < NumWords) {
+            Word |= Src[Hi] << (WordBits - BitShift);
+          }
+          Dst[Idx] = Word;
+        } else {
+          // Dst bit X = Src bit X - |Offset.X|
+          const auto Hi = Idx - WordShift;
+          const auto Lo = Hi - 1;
+          WordType Word = Hi >= 0 ? Src[Hi] << BitShift : 0;
+          if (BitShift != 0 && Lo >= 0) {
+            Word |= Src[Lo] >> (WordBits - BitShift);
+          }
+          Dst[Idx] = Word;
+        }
+      }
+    }
+    Result.clearPadding();
+    return Result;
+  }
+
+  /// Returns the word containing the tile P
+  inline WordType &word(TilePos P) {
+    return Data[P.Y * WordsPerRow + P.X / WordBits];
+  }
+
+  inline const WordType &word(TilePos P) const {
+    return Data[P.Y * WordsPerRow + P.X / WordBits];
+  }
+
+  /// Returns pointer to the getWordsPerRow() words of row Y
+  inline WordType *rowWords(TileCord Y) {
+    assert(0 <= Y && Y < Size.H && "Row out of bit map bounds");
+    return Data.data() + Y * WordsPerRow;
+  }
+
+  inline const WordType *rowWords(TileCord Y) const {
+    assert(0 <= Y && Y < Size.H && "Row out of bit map bounds");
+    return Data.data() + Y * WordsPerRow;
+  }
+
+  /// Returns the mask of bits used in the last word of a row
+  WordType getLastWordMask() const {
+    const auto UsedBits = Size.W % WordBits;
+    return UsedBits == 0 ? ~WordType(0) : (WordType(1) << UsedBits) - 1;
+  }
+
+  /// Clears the unused bits of the last word in each row, needs to be called
+  /// after modifying words directly
+  void clearPadding() {
+    if (WordsPerRow == 0) {
+      return;
+    }
+    const auto Mask = getLastWordMask();
+    for (TileCord PY = 0; PY < Size.H; PY++) {
+      rowWords(PY)[WordsPerRow - 1] &= Mask;
+    }
+  }
+
+  DataType &getData() { return Data; }
+  const DataType &getData() const { return Data; }
+
+private:
+  Size2d<TileCord> Size;
+  std::size_t WordsPerRow = 0;
+  DataType Data;
+};
+
+template <typename U>
+inline BitMap<U> operator&(BitMap<U> Lhs, const BitMap<U> &Rhs) {
+  return Lhs &= Rhs;
+}
+
+template <typename U>
+inline BitMap<U> operator|(BitMap<U> Lhs, const BitMap<U> &Rhs) {
+  return Lhs |= Rhs;
+}
+
+template <typename U>
+inline BitMap<U> operator^(BitMap<U> Lhs, const BitMap<U> &Rhs) {
+  return Lhs ^= Rhs;
+}
+
+template <typename U> inline BitMap<U> operator~(BitMap<U> BM) {
+  return BM.flip();
+}
+
+template <typename U>
+inline bool operator==(const BitMap<U> &Lhs, const BitMap<U> &Rhs) {
+  return Lhs.getSize() == Rhs.getSize() && Lhs.getData() == Rhs.getData();
+}
+
+template <typename U>
+inline bool operator!=(const BitMap<U> &Lhs, const BitMap<U> &Rhs) {
+  return !(Lhs == Rhs);
+}
+
+template <typename U>
+std::ostream &operator<<(std::ostream &Out, const BitMap<U> &BM) {
+  for (U PY = 0; PY < BM.getSize().H; PY++) {
+    for (U PX = 0; PX < BM.getSize().W; PX++) {
+      Out << BM.getTileUnchecked({PX, PY});
+    }
+    Out << '\n';
+  }
+  return Out;
+}
+
+} // namespace ymir
+
+#endif // #ifndef YMIR_BIT_MAP_HPP
@@ -1,16 +1,43 @@
 #ifndef YMIR_CELLULAR_AUTOMATA_HPP
 #define YMIR_CELLULAR_AUTOMATA_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <ymir/Executor.hpp>
 #include <ymir/Map.hpp>
 
 namespace ymir {
 
+namespace detail {
+
+/// True if the map provides pointers to contiguous rows of tiles via row(Y)
+template <typename MapType, typename = void>
+struct HasTileRows : std::false_type {};
+
+template <typename MapType>
+struct HasTileRows<MapType,
+                   std::void_t<decltype(std::declval<const MapType &>().row(
+                       typename MapType::TileCord()))>>
+    : std::bool_constant<!std::is_same_v<typename MapType::TileType, bool>> {};
+
+} // namespace detail
+
 namespace celat {
 
-template <typename TileType, typename U>
-void generate(Map<TileType, U> &M, TileType Tile, std::size_t NeighborThres,
+// The rules only use forEach and getNeighborCount of the map, so they also run
+// on a TiledMap or PaddedMap
+
+template <typename MapType, typename U = typename MapType::TileCord>
+void generate(MapType &M, typename MapType::TileType Tile,
+              std::size_t NeighborThres,
               std::optional<Rect2d<typename nd<U>::type>> Rect = {}) {
+  using TileType = typename MapType::TileType;
   M.forEach(
       [&M, Tile, NeighborThres](Point2d<U> P, TileType &MapTile) {
         if (M.getNeighborCount(P, Tile) >= NeighborThres) {
@@ -20,10 +47,11 @@ void generate(Map<TileType, U> &M, TileType Tile, std::size_t NeighborThres,
       Rect);
 }
 
-template <typename TileType, typename U>
-void replace(Map<TileType, U> &M, TileType TargetTile, TileType ReplaceTile,
-             std::size_t NeighborThres,
+template <typename MapType, typename U = typename MapType::TileCord>
+void replace(MapType &M, typename MapType::TileType TargetTile,
+             typename MapType::TileType ReplaceTile, std::size_t NeighborThres,
              std::optional<Rect2d<typename nd<U>::type>> Rect = {}) {
+  using TileType = typename MapType::TileType;
   M.forEach(
       [&M, TargetTile, ReplaceTile, NeighborThres](Point2d<U> P,
                                                    TileType &MapTile) {
@@ -37,8 +65,581 @@ void replace(Map<TileType, U> &M, TileType TargetTile, TileType ReplaceTile,
       Rect);
 }
 
+/// Order in which the automaton updates the tiles of a generation
+enum class UpdateMode {
+  /// Every tile of a generation is computed from the previous generation
+  Synchronous,
+  /// Tiles are updated in place in row-major order and see the already
+  /// updated neighbors, same as celat::generate and celat::replace
+  InPlace,
+};
+
+/// Cellular automaton engine for the threshold rules above, running any number
+/// of generations per call.
+///
+/// In synchronous mode the tiles matching the rule's tile are tracked in a
+/// byte mask with a one tile border and the generations ping-pong between two
+/// mask buffers. Neighbor counts are computed row by row from the column sums
+/// of three mask rows, eight cells per 64 bit word. The map is only
+/// read before the first and written after the last generation. Tiles outside
+/// of the map never match, tiles outside of the rect keep their state.
+///
+/// Given an executor each generation is split into row bands. The bands of a
+/// generation only read the previous generation, the rows next to a band are
+/// its halo and are taken from the shared buffer. The executor returning from
+/// run separates the generations, the result is identical to the single
+/// threaded one.
+///
+/// The in-place mode forwards to the per tile rules and gives the exact
+/// results of the legacy implementation, it always runs sequentially.
+template <typename U = int> class Automaton {
+public:
+  using TileCord = U;
+  using CellType = std::uint8_t;
+  using WordType = std::uint64_t;
+
+private:
+  // Rules on the mask, applied to single cells as well as to words of cells
+  struct GenerateRule {
+    template <typename V> V operator()(V Cell, V Reached) const {
+      return Cell | Reached;
+    }
+  };
+  struct ReplaceRule {
+    template <typename V> V operator()(V Cell, V Reached) const {
+      return Cell & Reached;
+    }
+  };
+
+public:
+  /// FusedGenerations > 1 computes that many generations per pass over the
+  /// mask, which only applies to the synchronous mode
+  explicit Automaton(UpdateMode Mode = UpdateMode::Synchronous,
+                     std::size_t FusedGenerations = 1)
+      : Mode(Mode),
+        FusedGenerations(std::max<std::size_t>(FusedGenerations, 1)) {}
+
+  UpdateMode getMode() const { return Mode; }
+  std::size_t getFusedGenerations() const { return FusedGenerations; }
+
+  /// Runs celat::generate for the given number of generations
+  template <typename MapType>
+  void generate(MapType &M, typename MapType::TileType Tile,
+                std::size_t NeighborThres, std::size_t Iterations = 1,
+                std::optional<Rect2d<TileCord>> Rect = {}) {
+    SequentialExecutor Exec;
+    generate(Exec, M, Tile, NeighborThres, Iterations, Rect);
+  }
+
+  template <typename Executor, typename MapType,
+            typename = std::enable_if_t<IsExecutorV<Executor>>>
+  void generate(Executor &Exec, MapType &M, typename MapType::TileType Tile,
+                std::size_t NeighborThres, std::size_t Iterations = 1,
+                std::optional<Rect2d<TileCord>> Rect = {}) {
+    if (Mode == UpdateMode::InPlace) {
+      for (std::size_t Idx = 0; Idx < Iterations; Idx++) {
+        celat::generate(M, Tile, NeighborThres, Rect);
+      }
+      return;
+    }
+    const auto R = loadMask(Exec, M, Tile, Rect);
+    const CellType Thres = clampThres(NeighborThres);
+    run(Exec, R.Size, Thres, Iterations, GenerateRule());
+    storeMask(Exec, M, R, generateStore(Tile));
+  }
+
+  /// Runs celat::generate until a generation changes no tile, at most
+  /// MaxIterations generations. Returns the number of generations that
+  /// changed the map, running more generations gives the same map.
+  ///
+  /// In synchronous mode only the tiles next to a tile changed by the
+  /// previous generation are evaluated, the whole map is only scanned while
+  /// a large part of it changes.
+  template <typename MapType>
+  std::size_t generateUntilStable(MapType &M, typename MapType::TileType Tile,
+                                  std::size_t NeighborThres,
+                                  std::size_t MaxIterations,
+                                  std::optional<Rect2d<TileCord>> Rect = {}) {
+    if (Mode == UpdateMode::InPlace) {
+      return runInPlaceUntilStable(M, MaxIterations, [&] {
+        celat::generate(M, Tile, NeighborThres, Rect);
+      });
+    }
+    SequentialExecutor Exec;
+    const auto R = loadMask(Exec, M, Tile, Rect);
+    const auto Generations = runUntilStable(R.Size, clampThres(NeighborThres),
+                                            MaxIterations, GenerateRule());
+    storeMask(Exec, M, R, generateStore(Tile));
+    return Generations;
+  }
+
+  /// Runs celat::replace for the given number of generations
+  template <typename MapType>
+  void replace(MapType &M, typename MapType::TileType TargetTile,
+               typename MapType::TileType ReplaceTile,
+               std::size_t NeighborThres, std::size_t Iterations = 1,
+               std::optional<Rect2d<TileCord>> Rect = {}) {
+    SequentialExecutor Exec;
+    replace(Exec, M, TargetTile, ReplaceTile, NeighborThres, Iterations, Rect);
+  }
+
+  template <typename Executor, typename MapType,
+            typename = std::enable_if_t<IsExecutorV<Executor>>>
+  void replace(Executor &Exec, MapType &M,
+               typename MapType::TileType TargetTile,
+               typename MapType::TileType ReplaceTile,
+               std::size_t NeighborThres, std::size_t Iterations = 1,
+               std::optional<Rect2d<TileCord>> Rect = {}) {
+    if (Mode == UpdateMode::InPlace) {
+      for (std::size_t Idx = 0; Idx < Iterations; Idx++) {
+        celat::replace(M, TargetTile, ReplaceTile, NeighborThres, Rect);
+      }
+      return;
+    }
+    const auto R = loadMask(Exec, M, TargetTile, Rect);
+    const CellType Thres = clampThres(NeighborThres);
+    run(Exec, R.Size, Thres, Iterations, ReplaceRule());
+    storeMask(Exec, M, R, replaceStore(TargetTile, ReplaceTile));
+  }
+
+  /// Runs celat::replace until a generation changes no tile, see
+  /// generateUntilStable
+  template <typename MapType>
+  std::size_t replaceUntilStable(MapType &M,
+                                 typename MapType::TileType TargetTile,
+                                 typename MapType::TileType ReplaceTile,
+                                 std::size_t NeighborThres,
+                                 std::size_t MaxIterations,
+                                 std::optional<Rect2d<TileCord>> Rect = {}) {
+    if (Mode == UpdateMode::InPlace) {
+      return runInPlaceUntilStable(M, MaxIterations, [&] {
+        celat::replace(M, TargetTile, ReplaceTile, NeighborThres, Rect);
+      });
+    }
+    SequentialExecutor Exec;
+    const auto R = loadMask(Exec, M, TargetTile, Rect);
+    const auto Generations = runUntilStable(R.Size, clampThres(NeighborThres),
+                                            MaxIterations, ReplaceRule());
+    storeMask(Exec, M, R, replaceStore(TargetTile, ReplaceTile));
+    return Generations;
+  }
+
+private:
+  static CellType clampThres(std::size_t NeighborThres) {
+    // Counts never exceed 8, larger thresholds can never be reached
+    return static_cast<CellType>(std::min<std::size_t>(NeighborThres, 9));
+  }
+
+  template <typename TileType> static auto generateStore(TileType Tile) {
+    return [Tile](auto &MapTile, CellType Cell) {
+      MapTile = Cell ? Tile : MapTile;
+    };
+  }
+
+  template <typename TileType>
+  static auto replaceStore(TileType TargetTile, TileType ReplaceTile) {
+    return [TargetTile, ReplaceTile](auto &MapTile, CellType Cell) {
+      MapTile = (!Cell && MapTile == TargetTile) ? ReplaceTile : MapTile;
+    };
+  }
+
+  template <typename MapType, typename GenerationFunc>
+  static std::size_t runInPlaceUntilStable(MapType &M,
+                                           std::size_t MaxIterations,
+                                           GenerationFunc Generation) {
+    for (std::size_t Idx = 0; Idx < MaxIterations; Idx++) {
+      const MapType Prev = M;
+      Generation();
+      if (M == Prev) {
+        return Idx;
+      }
+    }
+    return MaxIterations;
+  }
+
+  static WordType loadWord(const CellType *Ptr) {
+    WordType Word;
+    std::memcpy(&Word, Ptr, sizeof(Word));
+    return Word;
+  }
+
+  static void storeWord(CellType *Ptr, WordType Word) {
+    std::memcpy(Ptr, &Word, sizeof(Word));
+  }
+
+  /// Returns pointer to the first cell of row Y of the rect in Buffer
+  CellType *cellRow(std::vector<CellType> &Buffer, TileCord Y) const {
+    return Buffer.data() + static_cast<std::size_t>(Y + 1) * Stride + 1;
+  }
+
+  template <typename Executor, typename MapType>
+  Rect2d<TileCord> loadMask(Executor &Exec, const MapType &M,
+                            const typename MapType::TileType &Tile,
+                            std::optional<Rect2d<TileCord>> Rect) {
+    const auto R = Rect ? M.rect() & *Rect : M.rect();
+    Stride = static_cast<std::size_t>(R.Size.W) + 2;
+    Cur.assign(Stride * (static_cast<std::size_t>(R.Size.H) + 2), 0);
+
+    // Only the one tile border around the rect may be outside of the map
+    auto LoadChecked = [&M, &Tile](Point2d<TileCord> P) -> CellType {
+      return M.contains(P) && M.getTileUnchecked(P) == Tile;
+    };
+    for (const TileCord PY : {TileCord(-1), R.Size.H}) {
+      CellType *Row = cellRow(Cur, PY);
+      for (TileCord PX = -1; PX <= R.Size.W; PX++) {
+        Row[PX] = LoadChecked({R.Pos.X + PX, R.Pos.Y + PY});
+      }
+    }
+
+    forEachRowBand(Exec, Rect2d<TileCord>{{0, 0}, R.Size},
+                   [&](std::size_t, Rect2d<TileCord> Band) {
+                     for (auto PY = Band.Pos.Y; PY < Band.Pos.Y + Band.Size.H;
+                          PY++) {
+                       CellType *Row = cellRow(Cur, PY);
+                       const auto Y = R.Pos.Y + PY;
+                       Row[-1] = LoadChecked({R.Pos.X - 1, Y});
+                       loadRow(M, Tile, {R.Pos.X, Y}, R.Size.W, Row);
+                       Row[R.Size.W] = LoadChecked({R.Pos.X + R.Size.W, Y});
+                     }
+                   });
+
+    // The border is never written by a generation, both buffers need it
+    Next = Cur;
+    return R;
+  }
+
+  template <typename MapType>
+  static void loadRow(const MapType &M, const typename MapType::TileType &Tile,
+                      Point2d<TileCord> Pos, TileCord Width, CellType *Row) {
+    if constexpr (detail::HasTileRows<MapType>::value) {
+      const auto *Tiles = M.row(Pos.Y) + Pos.X;
+      for (TileCord PX = 0; PX < Width; PX++) {
+        Row[PX] = Tiles[PX] == Tile;
+      }
+    } else {
+      for (TileCord PX = 0; PX < Width; PX++) {
+        Row[PX] = M.getTileUnchecked({Pos.X + PX, Pos.Y}) == Tile;
+      }
+    }
+  }
+
+  template <typename Executor, typename MapType, typename StoreFunc>
+  void storeMask(Executor &Exec, MapType &M, Rect2d<TileCord> R,
+                 StoreFunc Store) {
+    forEachRowBand(
+        Exec, R, [this, &M, &R, &Store](std::size_t, Rect2d<TileCord> Band) {
+          for (auto Y = Band.Pos.Y; Y < Band.Pos.Y + Band.Size.H; Y++) {
+            const CellType *Row = cellRow(Cur, Y - R.Pos.Y);
+            if constexpr (detail::HasTileRows<MapType>::value) {
+              // Keep the row pointer local, tile stores could otherwise alias
+              // the map's members and force reloading them for every tile
+              auto *Tiles = M.row(Y) + R.Pos.X;
+              for (TileCord PX = 0; PX < R.Size.W; PX++) {
+                Store(Tiles[PX], Row[PX]);
+              }
+            } else {
+              for (TileCord PX = 0; PX < R.Size.W; PX++) {
+                Store(M.getTileUnchecked({R.Pos.X + PX, Y}), Row[PX]);
+              }
+            }
+          }
+        });
+  }
+
+  /// Computes the next generation band by band
+  template <typename Executor, typename RuleFunc>
+  void step(Executor &Exec, Size2d<TileCord> Size, CellType Thres,
+            RuleFunc Rule) {
+    const auto Bands = getRowBands(Exec, Rect2d<TileCord>{{0, 0}, Size});
+    if (BandCols.size() < Bands.size()) {
+      BandCols.resize(Bands.size());
+    }
+    Exec.run(Bands.size(), [&](std::size_t Idx) {
+      BandCols[Idx].resize(Stride);
+      const auto First = static_cast<std::size_t>(Bands[Idx].Pos.Y);
+      stepRows(Cur.data() + First * Stride, Next.data() + (First + 1) * Stride,
+               Size.W, Bands[Idx].Size.H, Thres, Rule, BandCols[Idx].data());
+    });
+    std::swap(Cur, Next);
+  }
+
+  /// Computes the given number of generations at once. Each band is split
+  /// into blocks of rows that are advanced through all generations while
+  /// their rows stay in cache. A block starts from its rows plus one halo row
+  /// per generation above and below, every generation the rows computed
+  /// shrink by one on both sides (trapezoidal tiling). Halo rows are computed
+  /// redundantly by the neighboring blocks, the blocks are independent.
+  template <typename Executor, typename RuleFunc>
+  void stepFused(Executor &Exec, Size2d<TileCord> Size, CellType Thres,
+                 std::size_t Generations, RuleFunc Rule) {
+    const auto Halo = static_cast<TileCord>(Generations);
+    // Both block buffers of a band are meant to fit into the L2 cache, while
+    // the redundant halo rows are kept below a quarter of the rows computed
+    constexpr std::size_t BlockBytes = std::size_t(1) << 19;
+    const auto CacheRows =
+        static_cast<TileCord>(BlockBytes / 2 / Stride) - 2 * Halo;
+    const TileCord BlockRows = std::max<TileCord>(CacheRows, 4 * Halo);
+
+    const auto Bands = getRowBands(Exec, Rect2d<TileCord>{{0, 0}, Size});
+    BandCols.resize(std::max(BandCols.size(), Bands.size()));
+    BandBlocks.resize(std::max(BandBlocks.size(), Bands.size()));
+    Exec.run(Bands.size(), [&](std::size_t Idx) {
+      BandCols[Idx].resize(Stride);
+      const auto &Band = Bands[Idx];
+      for (TileCord Y = Band.Pos.Y; Y < Band.Pos.Y + Band.Size.H;
+           Y += BlockRows) {
+        const auto Rows = std::min(BlockRows, Band.Pos.Y + Band.Size.H - Y);
+        stepBlock(Y, Rows, Size, Halo, Thres, Rule, BandCols[Idx].data(),
+                  BandBlocks[Idx]);
+      }
+    });
+    std::swap(Cur, Next);
+  }
+
+  /// Advances the mask rows [Y, Y + Rows) by Halo generations. The first
+  /// generation reads from Cur and the last one writes to Next, the ones in
+  /// between ping-pong between the block buffers.
+  template <typename RuleFunc>
+  void stepBlock(TileCord Y, TileCord Rows, Size2d<TileCord> Size,
+                 TileCord Halo, CellType Thres, RuleFunc Rule, CellType *Cols,
+                 std::pair<std::vector<CellType>, std::vector<CellType>>
+                     &Block) {
+    // Rows of the padded mask in the block, the border rows never change
+    const TileCord First = std::max<TileCord>(Y - Halo, -1);
+    const TileCord Last = std::min<TileCord>(Y + Rows + Halo, Size.H + 1);
+    const auto BlockSize = static_cast<std::size_t>(Last - First) * Stride;
+    std::vector<CellType> *Out = &Block.first, *Spare = &Block.second;
+    for (auto *Buffer : {Out, Spare}) {
+      Buffer->resize(BlockSize);
+      CellType *Dst = Buffer->data();
+      const CellType *Src =
+          Cur.data() + static_cast<std::size_t>(First + 1) * Stride;
+      for (TileCord PY = First; PY < Last; PY++, Src += Stride, Dst += Stride) {
+        if (PY < 0 || PY >= Size.H) {
+          std::memcpy(Dst, Src, Stride);
+        } else {
+          Dst[0] = Src[0];
+          Dst[Stride - 1] = Src[Stride - 1];
+        }
+      }
+    }
+
+    // Offset of mask row PY in a buffer starting with mask row Base
+    auto RowOffset = [this](TileCord PY, TileCord Base) {
+      return static_cast<std::size_t>(PY - Base) * Stride;
+    };
+    const CellType *Src = Cur.data();
+    TileCord SrcBase = -1;
+    for (TileCord Gen = 1; Gen < Halo; Gen++) {
+      const TileCord From = std::max<TileCord>(Y - Halo + Gen, 0);
+      const TileCord To = std::min<TileCord>(Y + Rows + Halo - Gen, Size.H);
+      stepRows(Src + RowOffset(From - 1, SrcBase),
+               Out->data() + RowOffset(From, First), Size.W, To - From, Thres,
+               Rule, Cols);
+      Src = Out->data();
+      SrcBase = First;
+      std::swap(Out, Spare);
+    }
+    stepRows(Src + RowOffset(Y - 1, SrcBase), Next.data() + RowOffset(Y, -1),
+             Size.W, Rows, Thres, Rule, Cols);
+  }
+
+  /// Computes the next generation of Rows rows. Above points to the padded
+  /// row above the first row in the source buffer, Out to the padded first
+  /// row in the destination buffer. Cells are processed eight at a time as
+  /// bytes of a 64 bit word. Neighbor counts never exceed 8 so the per byte
+  /// sums can not carry into the next cell.
+  template <typename RuleFunc>
+  void stepRows(const CellType *Above, CellType *Out, TileCord RowWidth,
+                TileCord Rows, CellType Thres, RuleFunc Rule,
+                CellType *Cols) const {
+    constexpr std::size_t CellsPerWord = sizeof(WordType);
+    constexpr WordType Ones = ~WordType(0) / 0xff;
+    // Adding 0x80 - Thres to a count sets the top bit iff Count >= Thres
+    const WordType Bias = Ones * (0x80 - Thres);
+
+    const auto Width = static_cast<std::size_t>(RowWidth);
+    for (TileCord PY = 0; PY < Rows; PY++, Above += Stride, Out += Stride) {
+      const CellType *Mid = Above + Stride;
+      const CellType *Below = Mid + Stride;
+
+      std::size_t X = 0;
+      for (; X + CellsPerWord <= Stride; X += CellsPerWord) {
+        storeWord(Cols + X, loadWord(Above + X) + loadWord(Mid + X) +
+                                loadWord(Below + X));
+      }
+      for (; X < Stride; X++) {
+        Cols[X] = Above[X] + Mid[X] + Below[X];
+      }
+
+      X = 1;
+      for (; X + CellsPerWord <= Width + 1; X += CellsPerWord) {
+        const WordType Count = loadWord(Cols + X - 1) + loadWord(Cols + X) +
+                               loadWord(Cols + X + 1) - loadWord(Mid + X);
+        const WordType Reached = ((Count + Bias) >> 7) & Ones;
+        storeWord(Out + X, Rule(loadWord(Mid + X), Reached));
+      }
+      for (; X <= Width; X++) {
+        const int Count = Cols[X - 1] + Cols[X] + Cols[X + 1] - Mid[X];
+        const CellType Reached = Count >= Thres;
+        Out[X] = static_cast<CellType>(Rule(Mid[X], Reached));
+      }
+    }
+  }
+
+  /// Runs the given number of generations, fusing up to FusedGenerations
+  template <typename Executor, typename RuleFunc>
+  void run(Executor &Exec, Size2d<TileCord> Size, CellType Thres,
+           std::size_t Iterations, RuleFunc Rule) {
+    for (std::size_t Idx = 0; Idx < Iterations;) {
+      const auto Count = std::min(FusedGenerations, Iterations - Idx);
+      if (Count > 1) {
+        stepFused(Exec, Size, Thres, Count, Rule);
+      } else {
+        step(Exec, Size, Thres, Rule);
+      }
+      Idx += Count;
+    }
+  }
+
+  /// Runs generations on the mask until one changes no cell, cells are
+  /// only evaluated if a cell of their neighborhood changed
+  template <typename RuleFunc>
+  std::size_t runUntilStable(Size2d<TileCord> Size, CellType Thres,
+                             std::size_t MaxIterations, RuleFunc Rule) {
+    SequentialExecutor Exec;
+    const auto NumCells = static_cast<std::size_t>(Size.W) *
+                          static_cast<std::size_t>(Size.H);
+    // The border is marked as queued once so it never enters the frontier
+    Queued.assign(Cur.size(), 1);
+    for (TileCord PY = 0; PY < Size.H; PY++) {
+      std::fill_n(cellRow(Queued, PY), Size.W, 0);
+    }
+    const std::ptrdiff_t S = static_cast<std::ptrdiff_t>(Stride);
+    const std::ptrdiff_t Offsets[] = {-S - 1, -S,    -S + 1, -1,   0,
+                                      1,      S - 1, S,      S + 1};
+    // Evaluating a cell of the frontier costs about as much as scanning this
+    // many cells densely
+    constexpr std::size_t DenseFraction = 64;
+
+    bool Dense = true;
+    for (std::size_t Gen = 0; Gen < MaxIterations; Gen++) {
+      Changed.clear();
+      if (Dense) {
+        step(Exec, Size, Thres, Rule);
+        const auto NumChanged = countChanges(Size);
+        if (NumChanged == 0) {
+          return Gen;
+        }
+        // Scanning all cells is cheaper than a frontier covering a notable
+        // part of them
+        Dense = NumChanged * DenseFraction > NumCells;
+        if (Dense) {
+          continue;
+        }
+        collectChanges(Size);
+      } else {
+        for (const auto Idx : Frontier) {
+          const CellType *C = Cur.data() + Idx;
+          const int Count = C[-S - 1] + C[-S] + C[-S + 1] + C[-1] + C[1] +
+                            C[S - 1] + C[S] + C[S + 1];
+          const CellType Reached = Count >= Thres;
+          if (static_cast<CellType>(Rule(*C, Reached)) != *C) {
+            Changed.push_back(Idx);
+          }
+        }
+        if (Changed.empty()) {
+          return Gen;
+        }
+        // Apply after evaluating all cells, the generation is synchronous
+        for (const auto Idx : Changed) {
+          Cur[Idx] ^= 1;
+        }
+        Dense = Changed.size() * DenseFraction > NumCells;
+        if (Dense) {
+          continue;
+        }
+      }
+
+      Frontier.clear();
+      for (const auto Idx : Changed) {
+        for (const auto Offset : Offsets) {
+          const auto NIdx = static_cast<std::size_t>(Idx + Offset);
+          if (!Queued[NIdx]) {
+            Queued[NIdx] = 1;
+            Frontier.push_back(NIdx);
+          }
+        }
+      }
+      for (const auto Idx : Frontier) {
+        Queued[Idx] = 0;
+      }
+    }
+    return MaxIterations;
+  }
+
+  /// Returns the number of cells that differ between the current and the
+  /// previous generation, the latter is in Next after a step
+  std::size_t countChanges(Size2d<TileCord> Size) const {
+    constexpr std::size_t CellsPerWord = sizeof(WordType);
+    constexpr WordType Ones = ~WordType(0) / 0xff;
+    const auto Width = static_cast<std::size_t>(Size.W);
+    std::size_t Count = 0;
+    for (TileCord PY = 0; PY < Size.H; PY++) {
+      const auto Offset = static_cast<std::size_t>(PY + 1) * Stride + 1;
+      const CellType *New = Cur.data() + Offset;
+      const CellType *Old = Next.data() + Offset;
+      std::size_t X = 0;
+      for (; X + CellsPerWord <= Width; X += CellsPerWord) {
+        // Cells are 0 or 1, multiplying sums the bytes into the top byte
+        const WordType Diff = loadWord(New + X) ^ loadWord(Old + X);
+        Count += static_cast<std::size_t>((Diff * Ones) >> 56);
+      }
+      for (; X < Width; X++) {
+        Count += New[X] != Old[X];
+      }
+    }
+    return Count;
+  }
+
+  /// Collects the indices of the cells that differ between the current and
+  /// the previous generation
+  void collectChanges(Size2d<TileCord> Size) {
+    const auto Width = static_cast<std::size_t>(Size.W);
+    for (TileCord PY = 0; PY < Size.H; PY++) {
+      const CellType *New = cellRow(Cur, PY);
+      const CellType *Old = cellRow(Next, PY);
+      if (std::memcmp(New, Old, Width) == 0) {
+        continue;
+      }
+      const auto RowIdx = static_cast<std::size_t>(New - Cur.data());
+      for (std::size_t X = 0; X < Width; X++) {
+        if (New[X] != Old[X]) {
+          Changed.push_back(RowIdx + X);
+        }
+      }
+    }
+  }
+
+private:
+  UpdateMode Mode;
+  std::size_t FusedGenerations;
+  std::size_t Stride = 0;
+  std::vector<CellType> Cur;
+  std::vector<CellType> Next;
+  std::vector<std::vector<CellType>> BandCols;
+  // Block buffers of the fused generations per band
+  std::vector<std::pair<std::vector<CellType>, std::vector<CellType>>>
+      BandBlocks;
+
+  // State of the active frontier, indices are into the mask buffers
+  std::vector<CellType> Queued;
+  std::vector<std::size_t> Changed;
+  std::vector<std::size_t> Frontier;
+};
+
 } // namespace celat
 
 } // namespace ymir
 
-#endif // #ifndef YMIR_CELLULAR_AUTOMATA_HPP
\ No newline at end of file
+#endif // #ifndef YMIR_CELLULAR_AUTOMATA_HPP
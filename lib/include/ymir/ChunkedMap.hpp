@@ -0,0 +1,239 @@
+#ifndef YMIR_CHUNKED_MAP_HPP
+#define YMIR_CHUNKED_MAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <ymir/Map.hpp>
+#include <ymir/Types.hpp>
+
+namespace ymir {
+
+/// Map over an unbounded coordinate space that is split into chunks of a fixed
+/// size. Chunks are allocated on first access and filled by the generator,
+/// once the memory budget is exceeded the least recently used chunks are
+/// evicted. Evicted chunks are generated again on the next access, changes to
+/// them are lost unless an evict callback stores them.
+///
+/// References to tiles are only valid until the next access that loads a
+/// chunk, since that access may evict the chunk the reference points into.
+template <typename T, typename U = int> class ChunkedMap {
+public:
+  using TileType = T;
+  using TileCord = U;
+  using TilePos = Point2d<TileCord>;
+  using ChunkType = Map<TileType, TileCord>;
+
+  using reference = typename ChunkType::reference;
+
+  /// Called with the chunk to fill and the world position of its top-left tile
+  using GeneratorFunc = std::function<void(ChunkType &, TilePos)>;
+
+  /// Called before a chunk is evicted with the chunk and its world position
+  using EvictFunc = std::function<void(const ChunkType &, TilePos)>;
+
+  static constexpr std::size_t DefaultMemoryBudget = 64 * 1024 * 1024;
+
+public:
+  ChunkedMap(Size2d<TileCord> ChunkSize, GeneratorFunc Generator,
+             std::size_t MemoryBudget = DefaultMemoryBudget)
+      : ChunkSize(ChunkSize), Generator(std::move(Generator)) {
+    if (ChunkSize.W <= 0 || ChunkSize.H <= 0) {
+      throw std::out_of_range("Invalid chunk size for chunked map");
+    }
+    setMemoryBudget(MemoryBudget);
+  }
+
+  Size2d<TileCord> getChunkSize() const { return ChunkSize; }
+
+  /// Sets the budget in bytes for the tile data of all loaded chunks, at
+  /// least one chunk is kept loaded
+  void setMemoryBudget(std::size_t MemoryBudget) {
+    const std::size_t ChunkBytes =
+        static_cast<std::size_t>(ChunkSize.W * ChunkSize.H) * sizeof(TileType);
+    MaxChunks = std::max<std::size_t>(1, MemoryBudget / ChunkBytes);
+    evictToBudget();
+  }
+
+  std::size_t getMaxChunks() const { return MaxChunks; }
+
+  std::size_t getLoadedChunkCount() const { return Chunks.size(); }
+
+  void setEvictCallback(EvictFunc OnEvict) {
+    this->OnEvict = std::move(OnEvict);
+  }
+
+  /// Returns the chunk position that contains the world position P
+  TilePos getChunkPos(TilePos P) const {
+    return {floorDiv(P.X, ChunkSize.W), floorDiv(P.Y, ChunkSize.H)};
+  }
+
+  /// Returns the world position of the top-left tile of the chunk
+  TilePos getChunkOrigin(TilePos ChunkPos) const {
+    return {ChunkPos.X * ChunkSize.W, ChunkPos.Y * ChunkSize.H};
+  }
+
+  bool isLoaded(TilePos P) const {
+    return Chunks.count(getChunkPos(P)) != 0;
+  }
+
+  /// Returns the chunk at the given chunk position, loads it if needed
+  ChunkType &getChunk(TilePos ChunkPos) {
+    if (LastChunk && LastChunkPos == ChunkPos) {
+      return *LastChunk;
+    }
+    auto It = Chunks.find(ChunkPos);
+    if (It != Chunks.end()) {
+      Lru.splice(Lru.begin(), Lru, It->second.LruIt);
+    } else {
+      It = loadChunk(ChunkPos);
+    }
+    LastChunkPos = ChunkPos;
+    LastChunk = &It->second.Chunk;
+    return *LastChunk;
+  }
+
+  /// The chunked map is unbounded, every position is contained
+  inline constexpr bool contains(TilePos) const { return true; }
+
+  inline reference getTile(TilePos P) {
+    const auto ChunkPos = getChunkPos(P);
+    auto &Chunk = getChunk(ChunkPos);
+    return Chunk.getTileUnchecked(P - getChunkOrigin(ChunkPos));
+  }
+
+  inline reference getTileUnchecked(TilePos P) { return getTile(P); }
+
+  inline void setTile(TilePos P, TileType Tile) { getTile(P) = Tile; }
+
+  inline bool isTile(TilePos P, TileType Tile) { return getTile(P) == Tile; }
+
+  template <typename DirectionProvider = EightTileDirections<TileCord>>
+  std::size_t getNeighborCount(
+      TilePos P, TileType Tile,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) {
+    std::size_t Count = 0;
+    for (const auto &Dir : DirectionProvider::get()) {
+      Count += isTile(P + Dir, Tile);
+    }
+    return Count;
+  }
+
+  /// Iterates over all tiles of the rect chunk by chunk, loads the chunks as
+  /// needed. Calls binary function with world position and tile.
+  template <typename BinaryFunction>
+  void forEach(BinaryFunction Func, Rect2d<TileCord> Rect) {
+    forEachChunk(Rect, [&Func](ChunkType &Chunk, TilePos Origin,
+                               Rect2d<TileCord> Local) {
+      Chunk.forEach(
+          [&Func, &Origin](TilePos P, TileType &Tile) {
+            Func(P + Origin, Tile);
+          },
+          Local);
+    });
+  }
+
+  /// Returns copy of the tiles in the rect, e.g. for rendering a viewport
+  ChunkType copyRect(Rect2d<TileCord> Rect) {
+    ChunkType M(Rect.Size);
+    copyRect(Rect, M.view());
+    return M;
+  }
+
+  /// Copies the tiles in the rect row by row into Out with the rect's top-left
+  /// tile placed at Out's top-left tile
+  void copyRect(Rect2d<TileCord> Rect, typename ChunkType::ViewType Out) {
+    forEachChunk(Rect, [&Out, &Rect](ChunkType &Chunk, TilePos Origin,
+                                     Rect2d<TileCord> Local) {
+      Out.merge(Chunk.view(Local), Origin + Local.Pos - Rect.Pos);
+    });
+  }
+
+  /// Evicts all loaded chunks
+  void clear() {
+    while (!Lru.empty()) {
+      evictChunk();
+    }
+  }
+
+private:
+  struct ChunkEntry {
+    ChunkType Chunk;
+    typename std::list<TilePos>::iterator LruIt;
+  };
+  using ChunkMapType = std::unordered_map<TilePos, ChunkEntry>;
+
+  /// Calls Func with each chunk overlapping the rect, the chunk's origin and
+  /// the part of the rect within the chunk in chunk coordinates
+  template <typename ChunkFunction>
+  void forEachChunk(Rect2d<TileCord> Rect, ChunkFunction Func) {
+    if (Rect.empty()) {
+      return;
+    }
+    const auto First = getChunkPos(Rect.Pos);
+    const auto Last = getChunkPos(Rect.Pos + Rect.Size - TilePos{1, 1});
+    for (auto CY = First.Y; CY <= Last.Y; CY++) {
+      for (auto CX = First.X; CX <= Last.X; CX++) {
+        const auto Origin = getChunkOrigin({CX, CY});
+        auto &Chunk = getChunk({CX, CY});
+        Func(Chunk, Origin,
+             Chunk.rect() & Rect2d<TileCord>{Rect.Pos - Origin, Rect.Size});
+      }
+    }
+  }
+
+  static TileCord floorDiv(TileCord A, TileCord B) {
+    const TileCord Q = A / B;
+    return (A % B != 0 && (A < 0) != (B < 0)) ? Q - 1 : Q;
+  }
+
+  typename ChunkMapType::iterator loadChunk(TilePos ChunkPos) {
+    // Make room first, the new chunk must not be evicted right away
+    while (Chunks.size() >= MaxChunks) {
+      evictChunk();
+    }
+    ChunkType Chunk(ChunkSize);
+    Generator(Chunk, getChunkOrigin(ChunkPos));
+    Lru.push_front(ChunkPos);
+    return Chunks.emplace(ChunkPos, ChunkEntry{std::move(Chunk), Lru.begin()})
+        .first;
+  }
+
+  void evictChunk() {
+    const auto ChunkPos = Lru.back();
+    auto It = Chunks.find(ChunkPos);
+    if (OnEvict) {
+      OnEvict(It->second.Chunk, getChunkOrigin(ChunkPos));
+    }
+    if (LastChunk == &It->second.Chunk) {
+      LastChunk = nullptr;
+    }
+    Chunks.erase(It);
+    Lru.pop_back();
+  }
+
+  void evictToBudget() {
+    while (Chunks.size() > MaxChunks) {
+      evictChunk();
+    }
+  }
+
+private:
+  Size2d<TileCord> ChunkSize;
+  GeneratorFunc Generator;
+  EvictFunc OnEvict;
+  std::size_t MaxChunks = 1;
+
+  ChunkMapType Chunks;
+  std::list<TilePos> Lru;
+
+  TilePos LastChunkPos;
+  ChunkType *LastChunk = nullptr;
+};
+
+} // namespace ymir
+
+#endif // #ifndef YMIR_CHUNKED_MAP_HPP
@@ -17,12 +17,13 @@ template <typename TileType, typename OverrideType = char> struct DebugTile {
     return *this;
   }
 
-  template <typename U>
+  /// Converts a ymir::Map or ymir::MapView of TileType into a debug map
+  template <typename MapType, typename U = typename MapType::TileCord>
   static ymir::Map<DebugTile<TileType, OverrideType>, U>
-  convert(const Map<TileType, U> &M) {
-    ymir::Map<DebugTile<TileType, OverrideType>, U> Converted(M.Size);
+  convert(const MapType &M) {
+    ymir::Map<DebugTile<TileType, OverrideType>, U> Converted(M.getSize());
     M.forEach([&Converted](Point2d<U> Pos, const TileType &Tile) {
-      Converted.setTile(Pos, DebugTile<TileType, OverrideType>(Tile));
+      Converted.setTileUnchecked(Pos, DebugTile<TileType, OverrideType>(Tile));
     });
     return Converted;
   }
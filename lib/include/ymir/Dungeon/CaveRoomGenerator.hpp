@@ -3,13 +3,17 @@
 
 #include <ymir/CallularAutomata.hpp>
 #include <ymir/Dungeon/RoomGenerator.hpp>
+#include <ymir/LifeRule.hpp>
 
 namespace ymir::Dungeon {
 
-template <typename TileType, typename TileCord, typename RndEngType>
-class CaveRoomGenerator : public RoomGenerator<TileType, TileCord, RndEngType> {
+template <typename TileType, typename TileCord, typename RndEngType,
+          typename Alloc = std::allocator<TileType>>
+class CaveRoomGenerator
+    : public RoomGenerator<TileType, TileCord, RndEngType, Alloc> {
 public:
-  using RoomGeneratorType = RoomGenerator<TileType, TileCord, RndEngType>;
+  using RoomGeneratorType =
+      RoomGenerator<TileType, TileCord, RndEngType, Alloc>;
 
 public:
   static const char *Type;
@@ -18,26 +22,41 @@ public:
   using RoomGeneratorType::RoomGenerator;
   const char *getType() const override { return Type; }
 
-  Map<TileType, TileCord> generateRoomMap(Size2d<TileCord> Size) override;
-};
+  void init(BuilderPass &Pass, BuilderContext &C) override;
+  Map<TileType, TileCord, Alloc>
+  generateRoomMap(Size2d<TileCord> Size) override;
 
-template <typename T, typename U, typename RE>
-const char *CaveRoomGenerator<T, U, RE>::Type = "cave_room_generator";
+private:
+  std::optional<celat::LifeRule> CaRule;
+};
 
-template <typename U, typename T, typename RE>
-Map<T, U> generateCaveRoom(T Ground, T Wall, Size2d<U> Size, RE &RndEng) {
-  Map<T, U> Room(Size);
+template <typename T, typename U, typename RE, typename A>
+const char *CaveRoomGenerator<T, U, RE, A>::Type = "cave_room_generator";
+
+/// Generates a cave room, if a life-like rule is given it replaces the
+/// threshold based replacement step and runs on a bit map
+template <typename U, typename T, typename RE,
+          typename A = std::allocator<T>>
+Map<T, U, A> generateCaveRoom(T Ground, T Wall, Size2d<U> Size, RE &RndEng,
+                              const std::optional<celat::LifeRule> &CaRule = {},
+                              const A &Alloc = A()) {
+  Map<T, U, A> Room(Size, Alloc);
   Room.fillRect(Wall);
 
   // Generate initial ground tiles
   const float GroundChance = 0.85f;
-  fillRectRandom(Room, Ground, GroundChance, RndEng,
-                 Rect2d<U>{{1, 1}, {Size.W - 2, Size.H - 2}});
+  const Rect2d<U> Inner{{1, 1}, {Size.W - 2, Size.H - 2}};
+  fillRectRandom(Room, Ground, GroundChance, RndEng, Inner);
 
   // Run replacement
   const std::size_t ReplaceThres = 4, Iterations = 6;
-  for (std::size_t Idx = 0; Idx < Iterations; Idx++) {
-    celat::replace(Room, Ground, Wall, ReplaceThres);
+  if (CaRule) {
+    // Keep the wall border, births would otherwise open it
+    celat::applyLifeRule(Room, Ground, Wall, *CaRule, Iterations, Inner);
+  } else {
+    for (std::size_t Idx = 0; Idx < Iterations; Idx++) {
+      celat::replace(Room, Ground, Wall, ReplaceThres);
+    }
   }
 
   // Smooth generation
@@ -50,9 +69,19 @@ Map<T, U> generateCaveRoom(T Ground, T Wall, Size2d<U> Size, RE &RndEng) {
   return Room;
 }
 
-template <typename T, typename U, typename RE>
-Map<T, U> CaveRoomGenerator<T, U, RE>::generateRoomMap(Size2d<U> Size) {
-  return generateCaveRoom(T(), *this->Wall, Size, this->RndEng);
+template <typename T, typename U, typename RE, typename A>
+void CaveRoomGenerator<T, U, RE, A>::init(BuilderPass &Pass,
+                                          BuilderContext &C) {
+  RoomGeneratorType::init(Pass, C);
+  if (auto Rule = this->template getCfgOpt<std::string>("ca_rule")) {
+    CaRule = celat::LifeRule::parse(*Rule);
+  }
+}
+
+template <typename T, typename U, typename RE, typename A>
+Map<T, U, A> CaveRoomGenerator<T, U, RE, A>::generateRoomMap(Size2d<U> Size) {
+  return generateCaveRoom(T(), *this->Wall, Size, this->RndEng, CaRule,
+                          this->getCtx().get_allocator());
 }
 
 } // namespace ymir::Dungeon
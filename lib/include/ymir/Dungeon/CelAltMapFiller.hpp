@@ -1,11 +1,15 @@
 #ifndef YMIR_DUNGEON_CELALT_MAP_FILLER_HPP
 #define YMIR_DUNGEON_CELALT_MAP_FILLER_HPP
 
+#include <ymir/CallularAutomata.hpp>
+#include <ymir/Dungeon/Context.hpp>
 #include <ymir/Dungeon/RandomBuilder.hpp>
+#include <ymir/LifeRule.hpp>
 
 namespace ymir::Dungeon {
 
-template <typename TileType, typename TileCord, typename RandEngType>
+template <typename TileType, typename TileCord, typename RandEngType,
+          typename Alloc = std::allocator<TileType>>
 class CelAltMapFiller : public RandomBuilder<RandEngType> {
 public:
   static const char *Type;
@@ -28,13 +32,16 @@ private:
   unsigned KillThres = 8;
   float SpawnChance = 0.5f;
   bool HasBorder = true;
+  bool Synchronous = false;
+  unsigned FusedIterations = 1;
+  std::optional<celat::LifeRule> CaRule;
 };
 
-template <typename T, typename U, typename RE>
-const char *CelAltMapFiller<T, U, RE>::Type = "celalt_map_filler";
+template <typename T, typename U, typename RE, typename A>
+const char *CelAltMapFiller<T, U, RE, A>::Type = "celalt_map_filler";
 
-template <typename T, typename U, typename RE>
-void CelAltMapFiller<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+void CelAltMapFiller<T, U, RE, A>::init(BuilderPass &Pass, BuilderContext &C) {
   RandomBuilder<RE>::init(Pass, C);
   Layer = this->template getCfg<std::string>("layer");
   Tile = this->template getCfgOr<T>("tile", T());
@@ -47,15 +54,31 @@ void CelAltMapFiller<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
   SmoothThres = this->template getCfgOr<unsigned>("smooth_thres", SmoothThres);
   KillThres = this->template getCfgOr<unsigned>("kill_thres", KillThres);
   HasBorder = this->template getCfgOr<bool>("has_border", HasBorder);
+  FusedIterations =
+      this->template getCfgOr<unsigned>("fused_iterations", FusedIterations);
+  // Only synchronous updates can fuse generations, fusing implies them
+  const auto SyncCfg = this->template getCfgOpt<bool>("synchronous");
+  Synchronous = SyncCfg.value_or(FusedIterations > 1);
+  if (!Synchronous && FusedIterations > 1) {
+    throw std::runtime_error("fused_iterations of '" + this->getName() +
+                             "' requires synchronous updates");
+  }
+  if (auto Rule = this->template getCfgOpt<std::string>("ca_rule")) {
+    if (SyncCfg || FusedIterations > 1 ||
+        this->template getCfgOpt<unsigned>("replace_thres")) {
+      throw std::runtime_error(
+          "ca_rule of '" + this->getName() +
+          "' can not be combined with replace_thres, synchronous or "
+          "fused_iterations");
+    }
+    CaRule = celat::LifeRule::parse(*Rule);
+  }
 }
 
-template <typename T, typename U, typename RE>
-void CelAltMapFiller<T, U, RE>::run(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+void CelAltMapFiller<T, U, RE, A>::run(BuilderPass &Pass, BuilderContext &C) {
   RandomBuilder<RE>::run(Pass, C);
-  auto &Ctx = C.get<Context<T, U>>();
-
-  // FIXME we could use a buffer map here and by that avoid killing previously
-  // generated patterns
+  auto &Ctx = C.get<Context<T, U, A>>();
 
   // Get the map layer
   auto &M = Ctx.Map.get(Layer);
@@ -65,19 +88,31 @@ void CelAltMapFiller<T, U, RE>::run(BuilderPass &Pass, BuilderContext &C) {
   if (Rect.has_value()) {
     R = *Rect;
   }
-  ymir::fillRectRandom(M,Tile, SpawnChance, this->RndEng, R);
-
-  // Run replacement
-  for (std::size_t Idx = 0; Idx < Iterations; Idx++) {
-    ymir::celat::replace(M,Tile, ClearTile, ReplaceThres);
+  ymir::fillRectRandom(M, Tile, SpawnChance, this->RndEng, R);
+
+  // Synchronous updates compute each generation from a buffer of the previous
+  // one instead of overwriting patterns of the same generation, which also
+  // allows to compute several generations per pass over the map
+  celat::Automaton<U> CA(Synchronous ? celat::UpdateMode::Synchronous
+                                     : celat::UpdateMode::InPlace,
+                         FusedIterations);
+
+  // Run replacement, either by threshold or a life-like rule on a bit map.
+  // Stopping once the map settles is only cheap on the synchronous mask, in
+  // place it would need to copy and compare the map every generation
+  if (CaRule) {
+    celat::applyLifeRule(M, Tile, ClearTile, *CaRule, Iterations);
+  } else if (Synchronous && FusedIterations <= 1) {
+    CA.replaceUntilStable(M, Tile, ClearTile, ReplaceThres, Iterations);
+  } else {
+    CA.replace(M, Tile, ClearTile, ReplaceThres, Iterations);
   }
 
   // Smooth generation
-  ymir::celat::generate(M,Tile, SmoothThres);
+  CA.generate(M, Tile, SmoothThres);
 
   // Kill isolated tiles
-  ymir::celat::generate(M,ClearTile, KillThres);
-
+  CA.generate(M, ClearTile, KillThres);
 }
 
 } // namespace ymir::Dungeon
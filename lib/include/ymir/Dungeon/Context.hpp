@@ -2,6 +2,7 @@
 #define YMIR_DUNGEON_CONTEXT_HPP
 
 #include <list>
+#include <memory>
 #include <vector>
 #include <ymir/Dungeon/BuilderBase.hpp>
 #include <ymir/Dungeon/Hallway.hpp>
@@ -11,14 +12,37 @@
 
 namespace ymir::Dungeon {
 
-template <typename TileType, typename TileCord>
+/// Dungeon state shared by the builders. Rooms and hallways are allocated
+/// through the allocator of the layered map, e.g. a ymir::pmr::LayeredMap
+/// places the whole dungeon in one std::pmr::memory_resource.
+template <typename TileType, typename TileCord,
+          typename Alloc = std::allocator<TileType>>
 class Context : public BuilderContext {
+public:
+  using allocator_type = Alloc;
+  using MapType = LayeredMap<TileType, TileCord, Alloc>;
+  using RoomType = Dungeon::Room<TileType, TileCord, Alloc>;
+  using HallwayType = Dungeon::Hallway<TileType, TileCord, Alloc>;
+
+private:
+  template <typename V>
+  using Rebind =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<V>;
+
+public:
+  using RoomsType = std::list<RoomType, Rebind<RoomType>>;
+  using HallwaysType = std::vector<HallwayType, Rebind<HallwayType>>;
+
 public:
   static Rect2d<TileCord> getHallwayRect(Point2d<TileCord> PosA,
                                          Point2d<TileCord> PosB);
 
 public:
-  Context(LayeredMap<TileType, TileCord> &Map) : Map(Map) {}
+  Context(MapType &Map)
+      : Map(Map), Rooms(Rebind<RoomType>(Map.get_allocator())),
+        Hallways(Rebind<HallwayType>(Map.get_allocator())) {}
+
+  allocator_type get_allocator() const { return Map.get_allocator(); }
 
   /// Returns true if position is inside room and the position is empty
   /// \param Pos Position to check
@@ -31,65 +55,61 @@ public:
 
   bool isInHallway(Point2d<TileCord> Pos) const;
 
-  bool haveRoomsHallway(const Dungeon::Room<TileType, TileCord> &A,
-                        const Dungeon::Room<TileType, TileCord> &B) const;
+  bool haveRoomsHallway(const RoomType &RoomA, const RoomType &RoomB) const;
 
-  bool doesRoomFit(const Dungeon::Room<TileType, TileCord> &Room) const;
+  bool doesRoomFit(const RoomType &Room) const;
 
-  bool doesHallwayFit(
-      Rect2d<TileCord> HallwayRect,
-      const Dungeon::Room<TileType, TileCord> *TargetRoom = nullptr,
-      const Dungeon::Room<TileType, TileCord> *SourceRoom = nullptr) const;
+  bool doesHallwayFit(Rect2d<TileCord> HallwayRect,
+                      const RoomType *TargetRoom = nullptr,
+                      const RoomType *SourceRoom = nullptr) const;
 
-  bool doesRoomAndHallwayFit(
-      const Dungeon::Room<TileType, TileCord> &NewRoom,
-      Rect2d<TileCord> HallwayRect,
-      const Dungeon::Room<TileType, TileCord> &TargetRoom) const;
+  bool doesRoomAndHallwayFit(const RoomType &NewRoom,
+                             Rect2d<TileCord> HallwayRect,
+                             const RoomType &TargetRoom) const;
 
 public:
-  LayeredMap<TileType, TileCord> &Map;
-  std::list<Dungeon::Room<TileType, TileCord>> Rooms;
-  std::vector<Dungeon::Hallway<TileType, TileCord>> Hallways;
+  MapType &Map;
+  RoomsType Rooms;
+  HallwaysType Hallways;
 };
 
 // Returns true if position is inside room and the position is empty
-template <typename T, typename U>
-bool Context<T, U>::isInRoom(Point2d<U> Pos) const {
-  return std::any_of(Rooms.begin(), Rooms.end(),
-                     [&Pos](const Dungeon::Room<T, U> &Room) {
-                       return Room.rect().contains(Pos) &&
-                              Room.M.getTile(Pos - Room.Pos) == T();
-                     });
+template <typename T, typename U, typename A>
+bool Context<T, U, A>::isInRoom(Point2d<U> Pos) const {
+  return std::any_of(Rooms.begin(), Rooms.end(), [&Pos](const RoomType &Room) {
+    return Room.rect().contains(Pos) && Room.M.getTile(Pos - Room.Pos) == T();
+  });
 }
 
-template <typename T, typename U>
-bool Context<T, U>::blocksDoor(Point2d<U> Pos, bool Used) const {
+template <typename T, typename U, typename A>
+bool Context<T, U, A>::blocksDoor(Point2d<U> Pos, bool Used) const {
   return std::any_of(Rooms.begin(), Rooms.end(),
-                     [&Pos, Used](const Dungeon::Room<T, U> &Room) {
+                     [&Pos, Used](const RoomType &Room) {
                        return Room.blocksDoor(Pos - Room.Pos, Used);
                      });
 }
 
-template <typename T, typename U>
-bool Context<T, U>::isInHallway(Point2d<U> Pos) const {
+template <typename T, typename U, typename A>
+bool Context<T, U, A>::isInHallway(Point2d<U> Pos) const {
   return std::any_of(Hallways.begin(), Hallways.end(),
-                     [&Pos](const Dungeon::Hallway<T, U> &Hallway) {
+                     [&Pos](const HallwayType &Hallway) {
                        return Hallway.rect().contains(Pos);
                      });
 }
 
-template <typename T, typename U>
-bool Context<T, U>::haveRoomsHallway(const Dungeon::Room<T, U> &A,
-                                     const Dungeon::Room<T, U> &B) const {
-  return std::any_of(Hallways.begin(), Hallways.end(),
-                     [&A, &B](const Dungeon::Hallway<T, U> &Hallway) {
-                       return (Hallway.Src == &A && Hallway.Dst == &B) ||
-                              (Hallway.Src == &B && Hallway.Dst == &A);
-                     });
+template <typename T, typename U, typename A>
+bool Context<T, U, A>::haveRoomsHallway(const RoomType &RoomA,
+                                        const RoomType &RoomB) const {
+  return std::any_of(
+      Hallways.begin(), Hallways.end(),
+      [&RoomA, &RoomB](const HallwayType &Hallway) {
+        return (Hallway.Src == &RoomA && Hallway.Dst == &RoomB) ||
+               (Hallway.Src == &RoomB && Hallway.Dst == &RoomA);
+      });
 }
 
-template <typename T, typename U>
-bool Context<T, U>::doesRoomFit(const Dungeon::Room<T, U> &Room) const {
+template <typename T, typename U, typename A>
+bool Context<T, U, A>::doesRoomFit(const RoomType &Room) const {
   // If it's not contained in the map, it does not fit
   const auto RoomRect = Room.rect();
   if (!Map.rect().contains(RoomRect)) {
@@ -97,24 +117,23 @@ bool Context<T, U>::doesRoomFit(const Dungeon::Room<T, U> &Room) const {
   }
 
   // Check that the room neiter overlaps with another room nor with a hallway
-  bool RoomOverlapsRoom =
-      std::any_of(Rooms.begin(), Rooms.end(),
-                  [RoomRect](const Dungeon::Room<T, U> &OtherRoom) {
-                    return RoomRect.overlaps(OtherRoom.rect());
-                  });
+  bool RoomOverlapsRoom = std::any_of(
+      Rooms.begin(), Rooms.end(), [RoomRect](const RoomType &OtherRoom) {
+        return RoomRect.overlaps(OtherRoom.rect());
+      });
   bool RoopmOverlapsHallway =
       std::any_of(Hallways.begin(), Hallways.end(),
-                  [RoomRect](const Dungeon::Hallway<T, U> &Hallway) {
+                  [RoomRect](const HallwayType &Hallway) {
                     return RoomRect.overlaps(Hallway.rect());
                   });
 
   return !RoomOverlapsRoom && !RoopmOverlapsHallway;
 }
 
-template <typename T, typename U>
-bool Context<T, U>::doesHallwayFit(
-    Rect2d<U> HallwayRect, const Dungeon::Room<T, U> *TargetRoom,
-    const Dungeon::Room<T, U> *SourceRoom) const {
+template <typename T, typename U, typename A>
+bool Context<T, U, A>::doesHallwayFit(Rect2d<U> HallwayRect,
+                                      const RoomType *TargetRoom,
+                                      const RoomType *SourceRoom) const {
   // If it's not contained in the map, it does not fit
   if (!Map.rect().contains(HallwayRect)) {
     return false;
@@ -122,7 +141,7 @@ bool Context<T, U>::doesHallwayFit(
 
   bool HallwayOverlapsRooms = std::any_of(
       Rooms.begin(), Rooms.end(),
-      [&HallwayRect, TargetRoom, SourceRoom](const Dungeon::Room<T, U> &Room) {
+      [&HallwayRect, TargetRoom, SourceRoom](const RoomType &Room) {
         if (&Room == TargetRoom || &Room == SourceRoom) {
           return false;
         }
@@ -132,16 +151,16 @@ bool Context<T, U>::doesHallwayFit(
   return !HallwayOverlapsRooms;
 }
 
-template <typename T, typename U>
-bool Context<T, U>::doesRoomAndHallwayFit(
-    const Dungeon::Room<T, U> &NewRoom, Rect2d<U> HallwayRect,
-    const Dungeon::Room<T, U> &TargetRoom) const {
+template <typename T, typename U, typename A>
+bool Context<T, U, A>::doesRoomAndHallwayFit(const RoomType &NewRoom,
+                                             Rect2d<U> HallwayRect,
+                                             const RoomType &TargetRoom) const {
   return doesRoomFit(NewRoom) &&
          doesHallwayFit(HallwayRect, &TargetRoom, &NewRoom);
 }
 
-template <typename T, typename U>
-Rect2d<U> Context<T, U>::getHallwayRect(Point2d<U> PosA, Point2d<U> PosB) {
+template <typename T, typename U, typename A>
+Rect2d<U> Context<T, U, A>::getHallwayRect(Point2d<U> PosA, Point2d<U> PosB) {
   auto Hallway = Rect2d<U>::get(PosA, PosB);
   Hallway.Size += Size2d<U>(1, 1);
   return Hallway;
@@ -3,9 +3,12 @@
 
 #include <ymir/Dungeon/Context.hpp>
 #include <ymir/Dungeon/RandomBuilder.hpp>
+#include <ymir/Noise.hpp>
+#include <ymir/SummedAreaTable.hpp>
 
 namespace ymir::Dungeon {
-template <typename TileType, typename TileCord, typename RandomEngineType>
+template <typename TileType, typename TileCord, typename RandomEngineType,
+          typename Alloc = std::allocator<TileType>>
 class FilterPlacer : public RandomBuilder<RandomEngineType> {
 public:
   static const char *Type;
@@ -18,11 +21,22 @@ public:
   void init(BuilderPass &Pass, BuilderContext &C) override;
   void run(BuilderPass &Pass, BuilderContext &C) override;
 
-  bool check4xFilter(const Map<TileType, TileCord> &M,
+  bool check4xFilter(const Map<TileType, TileCord, Alloc> &M,
                      Point2d<TileCord> Pos) const;
-  bool check8xFilter(const Map<TileType, TileCord> &M,
+  bool check8xFilter(const Map<TileType, TileCord, Alloc> &M,
                      Point2d<TileCord> Pos) const;
 
+  /// Same as above with the neighbor counts of the filter tile taken from the
+  /// summed area table of the filter layer
+  bool check4xFilter(const SummedAreaTable<TileCord> &FilterCounts,
+                     Point2d<TileCord> Pos) const;
+  bool check8xFilter(const SummedAreaTable<TileCord> &FilterCounts,
+                     Point2d<TileCord> Pos) const;
+
+private:
+  bool check4xCount(std::size_t Count) const;
+  bool check8xCount(std::size_t Count) const;
+
 private:
   std::string FilterLayer;
   std::string PlaceLayer;
@@ -35,19 +49,21 @@ private:
   float PlacePercentage = 80.0;
 };
 
-template <typename T, typename U, typename RE>
-const char *FilterPlacer<T, U, RE>::Type = "filter_placer";
+template <typename T, typename U, typename RE, typename A>
+const char *FilterPlacer<T, U, RE, A>::Type = "filter_placer";
 
-template <typename T, typename U>
+template <typename T, typename U, typename A>
 std::vector<ymir::Dungeon::Object<U>>
-findPossibleLocations(const Dungeon::Room<T, U> &Room, T Ground, T Wall) {
+findPossibleLocations(const Dungeon::Room<T, U, A> &Room, T Ground, T Wall) {
   std::vector<ymir::Dungeon::Object<U>> Locations;
+  const auto WallCounts = SummedAreaTable<U>::fromTile(Room.M, Wall);
   Room.M.forEach(
-      [&Locations, &Room, Ground, Wall](ymir::Point2d<U> Pos, const T &Tile) {
+      [&Locations, &Room, &WallCounts, Ground](ymir::Point2d<U> Pos,
+                                               const T &Tile) {
         if (Tile != Ground || Room.blocksDoor(Pos)) {
           return;
         }
-        auto Count = Room.M.getNeighborCount(Pos, Wall);
+        auto Count = WallCounts.getNeighborCount(Pos);
         if (Count < 3) {
           return;
         }
@@ -56,8 +72,8 @@ findPossibleLocations(const Dungeon::Room<T, U> &Room, T Ground, T Wall) {
   return Locations;
 }
 
-template <typename T, typename U, typename RE>
-void FilterPlacer<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+void FilterPlacer<T, U, RE, A>::init(BuilderPass &Pass, BuilderContext &C) {
   RandomBuilder<RE>::init(Pass, C);
   FilterLayer = this->template getCfg<std::string>("filter_layer");
   PlaceLayer = this->template getCfg<std::string>("place_layer");
@@ -76,45 +92,79 @@ void FilterPlacer<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
       this->template getCfgOpt<unsigned>("filter8x_count_thres_max");
 }
 
-template <typename T, typename U, typename RE>
-bool FilterPlacer<T, U, RE>::check4xFilter(const Map<T, U> &M,
-                                           Point2d<U> Pos) const {
+template <typename T, typename U, typename RE, typename A>
+bool FilterPlacer<T, U, RE, A>::check4xCount(std::size_t Count) const {
   if (!Filter8xCountThresMin || !Filter8xCountThresMax) {
     return false;
   }
-  auto Count = M.getNeighborCount(Pos, *FilterTile, FourTileDirections<U>());
   return Count > *Filter4xCountThresMax || Count < *Filter4xCountThresMin;
 }
 
-template <typename T, typename U, typename RE>
-bool FilterPlacer<T, U, RE>::check8xFilter(const Map<T, U> &M,
-                                           Point2d<U> Pos) const {
+template <typename T, typename U, typename RE, typename A>
+bool FilterPlacer<T, U, RE, A>::check8xCount(std::size_t Count) const {
   if (!Filter4xCountThresMin || !Filter4xCountThresMax) {
     return false;
   }
-  auto Count = M.getNeighborCount(Pos, *FilterTile, EightTileDirections<U>());
   return Count > *Filter8xCountThresMax || Count < *Filter8xCountThresMin;
 }
 
-template <typename T, typename U, typename RE>
-void FilterPlacer<T, U, RE>::run(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+bool FilterPlacer<T, U, RE, A>::check4xFilter(const Map<T, U, A> &M,
+                                           Point2d<U> Pos) const {
+  return check4xCount(
+      M.getNeighborCount(Pos, *FilterTile, FourTileDirections<U>()));
+}
+
+template <typename T, typename U, typename RE, typename A>
+bool FilterPlacer<T, U, RE, A>::check8xFilter(const Map<T, U, A> &M,
+                                           Point2d<U> Pos) const {
+  return check8xCount(
+      M.getNeighborCount(Pos, *FilterTile, EightTileDirections<U>()));
+}
+
+template <typename T, typename U, typename RE, typename A>
+bool FilterPlacer<T, U, RE, A>::check4xFilter(
+    const SummedAreaTable<U> &FilterCounts, Point2d<U> Pos) const {
+  return check4xCount(
+      FilterCounts.getNeighborCount(Pos, FourTileDirections<U>()));
+}
+
+template <typename T, typename U, typename RE, typename A>
+bool FilterPlacer<T, U, RE, A>::check8xFilter(
+    const SummedAreaTable<U> &FilterCounts, Point2d<U> Pos) const {
+  return check8xCount(
+      FilterCounts.getNeighborCount(Pos, EightTileDirections<U>()));
+}
+
+template <typename T, typename U, typename RE, typename A>
+void FilterPlacer<T, U, RE, A>::run(BuilderPass &Pass, BuilderContext &C) {
   RandomBuilder<RE>::run(Pass, C);
-  auto &Ctx = C.get<Context<T, U>>();
+  auto &Ctx = C.get<Context<T, U, A>>();
   auto &FM = Ctx.Map.get(FilterLayer);
   auto &PM = Ctx.Map.get(PlaceLayer);
 
-  std::uniform_real_distribution<float> Uni(0.0, 100);
-  FM.forEach([&FM, &PM, this, &Uni](auto Pos, auto &Tile) {
-    if (Tile != T() || PM.getTile(Pos) != T()) {
-      return;
-    }
-
-    if (check4xFilter(FM, Pos) || check8xFilter(FM, Pos) ||
-        Uni(this->RndEng) > PlacePercentage) {
-      return;
-    }
-    PM.setTile(Pos, *PlaceTile);
-  });
+  // Counts are read either from the map or a summed area table of the filter
+  // tile, both provide the check4xFilter and check8xFilter overloads
+  const auto PlaceTiles = [&FM, &PM, this](const auto &Counts) {
+    FM.forEach([&Counts, &PM, this](auto Pos, auto &Tile) {
+      if (Tile != T() || PM.getTile(Pos) != T()) {
+        return;
+      }
+      if (check4xFilter(Counts, Pos) || check8xFilter(Counts, Pos) ||
+          randomFloat(this->RndEng, 0.0f, 100.0f) > PlacePercentage) {
+        return;
+      }
+      PM.setTile(Pos, *PlaceTile);
+    });
+  };
+
+  // Placed tiles change the filter counts mid-pass if both layers are the
+  // same, only a separate filter layer can be counted once up front
+  if (FilterLayer == PlaceLayer) {
+    PlaceTiles(FM);
+  } else {
+    PlaceTiles(SummedAreaTable<U>::fromTile(FM, *FilterTile));
+  }
 }
 
 } // namespace ymir::Dungeon
@@ -5,11 +5,12 @@
 
 namespace ymir::Dungeon {
 
-template <typename T, typename U> struct Hallway {
+template <typename T, typename U, typename Alloc = std::allocator<T>>
+struct Hallway {
   Rect2d<U> Rect;
-  Room<T, U> *Src = nullptr;
+  Room<T, U, Alloc> *Src = nullptr;
   Door<U> *SrcDoor = nullptr;
-  Room<T, U> *Dst = nullptr;
+  Room<T, U, Alloc> *Dst = nullptr;
   Door<U> *DstDoor = nullptr;
 
   Rect2d<U> rect() const { return Rect; }
@@ -6,7 +6,8 @@
 
 namespace ymir::Dungeon {
 
-template <typename TileType, typename TileCord, typename RndEngType>
+template <typename TileType, typename TileCord, typename RndEngType,
+          typename Alloc = std::allocator<TileType>>
 class LoopPlacer : public RandomBuilder<RndEngType> {
 public:
   static const char *Type;
@@ -27,8 +28,8 @@ protected:
   unsigned MaxUsedDoors = 0;
 };
 
-template <typename T, typename U, typename RE>
-const char *LoopPlacer<T, U, RE>::Type = "loop_placer";
+template <typename T, typename U, typename RE, typename A>
+const char *LoopPlacer<T, U, RE, A>::Type = "loop_placer";
 
 template <typename U>
 bool checkIfOpposing(Point2d<U> SrcPos, Dir2d SrcDir, Point2d<U> TgtPos,
@@ -51,11 +52,12 @@ bool checkIfOpposing(Point2d<U> SrcPos, Dir2d SrcDir, Point2d<U> TgtPos,
   return false;
 }
 
-template <typename T, typename U, typename RE>
-std::optional<Dungeon::Hallway<T, U>>
-getLoopHallway(Context<T, U> &Ctx, RE &RndEng, Dungeon::Room<T, U> &Source,
-               Dungeon::Room<T, U> &Target) {
-  std::vector<Dungeon::Hallway<T, U>> LoopHallways;
+template <typename T, typename U, typename RE, typename A>
+std::optional<Dungeon::Hallway<T, U, A>>
+getLoopHallway(Context<T, U, A> &Ctx, RE &RndEng,
+               Dungeon::Room<T, U, A> &Source,
+               Dungeon::Room<T, U, A> &Target) {
+  std::vector<Dungeon::Hallway<T, U, A>> LoopHallways;
   for (auto &SrcDoor : Source.Doors) {
     for (auto &TgtDoor : Target.Doors) {
       auto SrcPos = Source.Pos + SrcDoor.Pos;
@@ -66,9 +68,9 @@ getLoopHallway(Context<T, U> &Ctx, RE &RndEng, Dungeon::Room<T, U> &Source,
       }
       if ((SrcPos.X == TgtPos.X && SrcDoor.Dir.isVertical()) ||
           (SrcPos.Y == TgtPos.Y && SrcDoor.Dir.isHorizontal())) {
-        auto HallwayRect = Context<T, U>::getHallwayRect(SrcPos, TgtPos);
+        auto HallwayRect = Context<T, U, A>::getHallwayRect(SrcPos, TgtPos);
         if (Ctx.doesHallwayFit(HallwayRect, &Target, &Source)) {
-          LoopHallways.push_back(Dungeon::Hallway<T, U>{
+          LoopHallways.push_back(Dungeon::Hallway<T, U, A>{
               HallwayRect, &Source, &SrcDoor, &Target, &TgtDoor});
         }
       }
@@ -80,21 +82,21 @@ getLoopHallway(Context<T, U> &Ctx, RE &RndEng, Dungeon::Room<T, U> &Source,
   return *randomIterator(LoopHallways.begin(), LoopHallways.end(), RndEng);
 }
 
-template <typename T, typename U, typename RE>
-void LoopPlacer<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+void LoopPlacer<T, U, RE, A>::init(BuilderPass &Pass, BuilderContext &C) {
   BaseType::init(Pass, C);
   Layer = this->template getCfg<std::string>("layer");
   MaxLoops = this->template getCfg<unsigned>("max_loops");
   MaxUsedDoors = this->template getCfg<unsigned>("max_used_doors");
 }
 
-template <typename T, typename U, typename RE>
-void LoopPlacer<T, U, RE>::run(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+void LoopPlacer<T, U, RE, A>::run(BuilderPass &Pass, BuilderContext &C) {
   BaseType::init(Pass, C);
-  auto &Ctx = C.get<Context<T, U>>();
+  auto &Ctx = C.get<Context<T, U, A>>();
 
   // FIXME factor out into standalone func
-  std::vector<Dungeon::Hallway<T, U>> LoopHallways;
+  std::vector<Dungeon::Hallway<T, U, A>> LoopHallways;
   for (auto It = Ctx.Rooms.begin(); It != Ctx.Rooms.end(); It++) {
     if (It->getNumUsedDoors() >= MaxUsedDoors) {
       continue;
@@ -112,7 +114,7 @@ void LoopPlacer<T, U, RE>::run(BuilderPass &Pass, BuilderContext &C) {
   }
 
   // FIXME factor out into standalone func
-  std::shuffle(LoopHallways.begin(), LoopHallways.end(), this->RndEng);
+  randomShuffle(LoopHallways.begin(), LoopHallways.end(), this->RndEng);
   for (std::size_t Idx = 0; Idx < MaxLoops && Idx < LoopHallways.size();
        Idx++) {
     auto &Hallway = LoopHallways.at(Idx);
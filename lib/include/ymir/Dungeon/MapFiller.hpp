@@ -5,7 +5,8 @@
 
 namespace ymir::Dungeon {
 
-template <typename TileType, typename TileCord>
+template <typename TileType, typename TileCord,
+          typename Alloc = std::allocator<TileType>>
 class MapFiller : public BuilderBase {
 public:
   static const char *Type;
@@ -22,20 +23,20 @@ private:
   std::optional<TileType> Tile;
 };
 
-template <typename T, typename U>
-const char *MapFiller<T, U>::Type = "map_filler";
+template <typename T, typename U, typename A>
+const char *MapFiller<T, U, A>::Type = "map_filler";
 
-template <typename T, typename U>
-void MapFiller<T, U>::init(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename A>
+void MapFiller<T, U, A>::init(BuilderPass &Pass, BuilderContext &C) {
   BuilderBase::init(Pass, C);
   Layer = getCfg<std::string>("layer");
   Tile = getCfg<T>("tile");
 }
 
-template <typename T, typename U>
-void MapFiller<T, U>::run(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename A>
+void MapFiller<T, U, A>::run(BuilderPass &Pass, BuilderContext &C) {
   BuilderBase::run(Pass, C);
-  auto &Ctx = C.get<Context<T, U>>();
+  auto &Ctx = C.get<Context<T, U, A>>();
   Ctx.Map.get(Layer).fillRect(*Tile);
 }
 
@@ -5,16 +5,19 @@
 #include <tuple>
 #include <vector>
 #include <ymir/Dungeon/RoomGenerator.hpp>
+#include <ymir/Noise.hpp>
 
 namespace ymir::Dungeon {
 
 using RoomProbsType = std::vector<std::pair<std::string, float>>;
 
-template <typename TileType, typename TileCord, typename RndEngType>
+template <typename TileType, typename TileCord, typename RndEngType,
+          typename Alloc = std::allocator<TileType>>
 class RandomRoomGenerator
-    : public RoomGenerator<TileType, TileCord, RndEngType> {
+    : public RoomGenerator<TileType, TileCord, RndEngType, Alloc> {
 public:
-  using RoomGeneratorType = RoomGenerator<TileType, TileCord, RndEngType>;
+  using RoomGeneratorType =
+      RoomGenerator<TileType, TileCord, RndEngType, Alloc>;
 
 public:
   static const char *Type;
@@ -25,18 +28,20 @@ public:
 
   void init(BuilderPass &Pass, BuilderContext &C) override;
 
-  Room<TileType, TileCord> generate() override;
-  Map<TileType, TileCord> generateRoomMap(Size2d<TileCord> SIze) override;
+  Room<TileType, TileCord, Alloc> generate() override;
+  Map<TileType, TileCord, Alloc>
+  generateRoomMap(Size2d<TileCord> SIze) override;
 
 private:
   std::vector<std::pair<RoomGeneratorType *, float>> RoomGenProbs;
 };
 
-template <typename T, typename U, typename RE>
-const char *RandomRoomGenerator<T, U, RE>::Type = "random_room_generator";
+template <typename T, typename U, typename RE, typename A>
+const char *RandomRoomGenerator<T, U, RE, A>::Type = "random_room_generator";
 
-template <typename T, typename U, typename RE>
-void RandomRoomGenerator<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+void RandomRoomGenerator<T, U, RE, A>::init(BuilderPass &Pass,
+                                            BuilderContext &C) {
   RoomGeneratorType::init(Pass, C);
   auto RoomProbs = this->getSubCfg("room_probs/").template toVec<float>();
   // TODO default value?
@@ -50,15 +55,17 @@ void RandomRoomGenerator<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
         &this->getPass().template get<RoomGeneratorType>(RoomGenName);
     RoomGenProbs.emplace_back(RoomGen, Prob);
   }
-  std::sort(RoomGenProbs.begin(), RoomGenProbs.end(),
-            [](const auto &A, const auto &B) { return A.second < B.second; });
+  // The config is ordered by name, a stable sort keeps generators with equal
+  // probabilities in that order with every standard library
+  std::stable_sort(
+      RoomGenProbs.begin(), RoomGenProbs.end(),
+      [](const auto &L, const auto &R) { return L.second < R.second; });
   RoomGenProbs.back().second = 1.0;
 }
 
-template <typename T, typename U, typename RE>
-Room<T, U> RandomRoomGenerator<T, U, RE>::generate() {
-  std::uniform_real_distribution<float> Uni(0.0, 1.0);
-  auto Value = Uni(this->RndEng);
+template <typename T, typename U, typename RE, typename A>
+Room<T, U, A> RandomRoomGenerator<T, U, RE, A>::generate() {
+  auto Value = randomFloat(this->RndEng);
 
   for (auto const &[RoomGen, Prob] : RoomGenProbs) {
     if (Value <= Prob) {
@@ -69,8 +76,9 @@ Room<T, U> RandomRoomGenerator<T, U, RE>::generate() {
   throw std::runtime_error("should never be reached"); // FIXME
 }
 
-template <typename T, typename U, typename RE>
-Map<T, U> RandomRoomGenerator<T, U, RE>::generateRoomMap(Size2d<U> /*Size*/) {
+template <typename T, typename U, typename RE, typename A>
+Map<T, U, A>
+RandomRoomGenerator<T, U, RE, A>::generateRoomMap(Size2d<U> /*Size*/) {
   throw std::runtime_error("Not implmeneted");
 }
 
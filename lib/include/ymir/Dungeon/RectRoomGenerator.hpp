@@ -7,10 +7,13 @@ namespace ymir::Dungeon {
 
 // TODO rename MultiRectRoomGenerator and add (single) RectRoomGenerator?
 
-template <typename TileType, typename TileCord, typename RndEngType>
-class RectRoomGenerator : public RoomGenerator<TileType, TileCord, RndEngType> {
+template <typename TileType, typename TileCord, typename RndEngType,
+          typename Alloc = std::allocator<TileType>>
+class RectRoomGenerator
+    : public RoomGenerator<TileType, TileCord, RndEngType, Alloc> {
 public:
-  using RoomGeneratorType = RoomGenerator<TileType, TileCord, RndEngType>;
+  using RoomGeneratorType =
+      RoomGenerator<TileType, TileCord, RndEngType, Alloc>;
 
 public:
   static const char *Type;
@@ -19,15 +22,18 @@ public:
   using RoomGeneratorType::RoomGenerator;
   const char *getType() const override { return Type; }
 
-  Map<TileType, TileCord> generateRoomMap(Size2d<TileCord> SIze) override;
+  Map<TileType, TileCord, Alloc>
+  generateRoomMap(Size2d<TileCord> SIze) override;
 };
 
-template <typename T, typename U, typename RE>
-const char *RectRoomGenerator<T, U, RE>::Type = "rect_room_generator";
+template <typename T, typename U, typename RE, typename A>
+const char *RectRoomGenerator<T, U, RE, A>::Type = "rect_room_generator";
 
-template <typename U, typename T, typename RE>
-Map<T, U> generateMultiRectRoom(T Ground, T Wall, Size2d<U> Size, RE &RndEng) {
-  Map<T, U> Room(Size);
+template <typename U, typename T, typename RE,
+          typename A = std::allocator<T>>
+Map<T, U, A> generateMultiRectRoom(T Ground, T Wall, Size2d<U> Size,
+                                   RE &RndEng, const A &Alloc = A()) {
+  Map<T, U, A> Room(Size, Alloc);
   Room.fill(Wall);
 
   Rect2d<U> LastRoom = {Point2d<U>{0, 0}, Size2d<U>{Size.W + 1, Size.H + 1}};
@@ -53,9 +59,10 @@ Map<T, U> generateMultiRectRoom(T Ground, T Wall, Size2d<U> Size, RE &RndEng) {
   return Room;
 }
 
-template <typename T, typename U, typename RE>
-Map<T, U> RectRoomGenerator<T, U, RE>::generateRoomMap(Size2d<U> Size) {
-  return generateMultiRectRoom(T(), *this->Wall, Size, this->RndEng);
+template <typename T, typename U, typename RE, typename A>
+Map<T, U, A> RectRoomGenerator<T, U, RE, A>::generateRoomMap(Size2d<U> Size) {
+  return generateMultiRectRoom(T(), *this->Wall, Size, this->RndEng,
+                               this->getCtx().get_allocator());
 }
 
 } // namespace ymir::Dungeon
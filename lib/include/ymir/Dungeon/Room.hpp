@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <memory>
 #include <tuple>
 #include <vector>
 #include <ymir/DebugTile.hpp>
@@ -10,13 +11,21 @@
 #include <ymir/Map.hpp>
 #include <ymir/MapFilter.hpp>
 #include <ymir/Noise.hpp>
+#include <ymir/SummedAreaTable.hpp>
 #include <ymir/Types.hpp>
 
 namespace ymir::Dungeon {
 
-template <typename T, typename U> struct Room {
-  Map<T, U> M;
-  std::vector<Door<U>> Doors;
+/// Room map and its doors, both allocated through Alloc
+template <typename T, typename U, typename Alloc = std::allocator<T>>
+struct Room {
+  using MapType = Map<T, U, Alloc>;
+  using DoorsType = std::vector<
+      Door<U>,
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Door<U>>>;
+
+  MapType M;
+  DoorsType Doors;
   Point2d<U> Pos = {0, 0};
 
   Door<U> *getDoor(Dir2d Dir) {
@@ -64,8 +73,9 @@ template <typename T, typename U> struct Room {
 };
 
 namespace internal {
-template <typename T, typename U>
-void markDoors(ymir::Map<T, U> &M, const std::vector<Door<U>> &Doors,
+template <typename T, typename U, typename A, typename DoorAlloc>
+void markDoors(ymir::Map<T, U, A> &M,
+               const std::vector<Door<U>, DoorAlloc> &Doors,
                Point2d<U> Offset = {0, 0}) {
   for (const auto &Door : Doors) {
     switch (Door.Dir) {
@@ -88,8 +98,8 @@ void markDoors(ymir::Map<T, U> &M, const std::vector<Door<U>> &Doors,
 }
 } // namespace internal
 
-template <typename T, typename U>
-std::ostream &operator<<(std::ostream &Out, const Room<T, U> &Room) {
+template <typename T, typename U, typename A>
+std::ostream &operator<<(std::ostream &Out, const Room<T, U, A> &Room) {
   Out << "Room{" << Room.Pos << ", /*Doors=*/{";
   const char *Separator = "";
   for (const auto &Door : Room.Doors) {
@@ -103,14 +113,17 @@ std::ostream &operator<<(std::ostream &Out, const Room<T, U> &Room) {
   return Out;
 }
 
-template <typename T, typename U>
-std::vector<Door<U>> getDoorCandidates(Map<T, U> &Room, T Ground) {
-  std::vector<Door<U>> Doors;
-  Room.forEach([&Doors, &Room, Ground](Point2d<U> P, T &Tile) {
+/// Returns the doors of the room, allocated through the room's allocator
+template <typename T, typename U, typename A>
+typename Room<T, U, A>::DoorsType getDoorCandidates(Map<T, U, A> &Room,
+                                                    T Ground) {
+  typename Dungeon::Room<T, U, A>::DoorsType Doors(Room.get_allocator());
+  const auto GroundCounts = SummedAreaTable<U>::fromTile(Room, Ground);
+  Room.forEach([&Doors, &Room, &GroundCounts, Ground](Point2d<U> P, T &Tile) {
     if (Tile == Ground) {
       return;
     }
-    auto Count = Room.getNeighborCount(P, Ground);
+    auto Count = GroundCounts.getNeighborCount(P);
     if (Count != 3) {
       return;
     }
@@ -3,9 +3,12 @@
 
 #include <ymir/Dungeon/Context.hpp>
 #include <ymir/Dungeon/RandomBuilder.hpp>
+#include <ymir/Noise.hpp>
+#include <ymir/SummedAreaTable.hpp>
 
 namespace ymir::Dungeon {
-template <typename TileType, typename TileCord, typename RandomEngineType>
+template <typename TileType, typename TileCord, typename RandomEngineType,
+          typename Alloc = std::allocator<TileType>>
 class RoomEntityPlacer : public RandomBuilder<RandomEngineType> {
 public:
   static const char *Type;
@@ -28,20 +31,21 @@ private:
   bool CheckBlocksDoor = true;
 };
 
-template <typename T, typename U, typename RE>
-const char *RoomEntityPlacer<T, U, RE>::Type = "room_entity_placer";
+template <typename T, typename U, typename RE, typename A>
+const char *RoomEntityPlacer<T, U, RE, A>::Type = "room_entity_placer";
 
-template <typename T, typename U>
+template <typename T, typename U, typename A>
 std::vector<ymir::Dungeon::Object<U>>
-findPossibleRoomEntityLocations(const Dungeon::Room<T, U> &Room,
+findPossibleRoomEntityLocations(const Dungeon::Room<T, U, A> &Room,
                                 bool CheckBlocksDoor = true) {
   std::vector<ymir::Dungeon::Object<U>> Locations;
-  Room.M.forEach([&Locations, &Room, CheckBlocksDoor](ymir::Point2d<U> Pos,
-                                                      const T &Tile) {
+  const auto GroundCounts = SummedAreaTable<U>::fromTile(Room.M, T());
+  Room.M.forEach([&Locations, &Room, &GroundCounts,
+                  CheckBlocksDoor](ymir::Point2d<U> Pos, const T &Tile) {
     if (Tile != T() || (CheckBlocksDoor && Room.blocksDoor(Pos))) {
       return;
     }
-    auto Count = Room.M.getNotNeighborCount(Pos, T());
+    auto Count = GroundCounts.getNotNeighborCount(Pos);
     if (Count < 3) {
       return;
     }
@@ -50,9 +54,9 @@ findPossibleRoomEntityLocations(const Dungeon::Room<T, U> &Room,
   return Locations;
 }
 
-template <typename T, typename U>
+template <typename T, typename U, typename A, typename ListAlloc>
 std::vector<ymir::Dungeon::Object<U>> findPossibleRoomEntityLocations(
-    const std::list<ymir::Dungeon::Room<T, U>> &Rooms,
+    const std::list<ymir::Dungeon::Room<T, U, A>, ListAlloc> &Rooms,
     bool CheckBlocksDoor = true) {
   std::vector<ymir::Dungeon::Object<U>> Locations;
   for (const auto &Room : Rooms) {
@@ -63,22 +67,20 @@ std::vector<ymir::Dungeon::Object<U>> findPossibleRoomEntityLocations(
 }
 
 // 5% => A room entity in every ~20 rooms
-template <typename T, typename U, typename RndEngType>
-void addRandomRoomEntitys(Map<T, U> &M, T RoomEntity,
-                          const std::list<ymir::Dungeon::Room<T, U>> &Rooms,
-                          RndEngType RndEng, float RoomPercentage,
-                          unsigned RoomCountMin, unsigned RoomCountMax,
-                          bool CheckBlocksDoor = true) {
-  std::uniform_real_distribution<float> Uni(0.0, 100);
+template <typename T, typename U, typename A, typename ListAlloc,
+          typename RndEngType>
+void addRandomRoomEntitys(
+    Map<T, U, A> &M, T RoomEntity,
+    const std::list<ymir::Dungeon::Room<T, U, A>, ListAlloc> &Rooms,
+    RndEngType RndEng, float RoomPercentage, unsigned RoomCountMin,
+    unsigned RoomCountMax, bool CheckBlocksDoor = true) {
   for (const auto &Room : Rooms) {
-    if (Uni(RndEng) > RoomPercentage) {
+    if (randomFloat(RndEng, 0.0f, 100.0f) > RoomPercentage) {
       continue;
     }
-    std::uniform_int_distribution<unsigned> RndRoomCount(RoomCountMin,
-                                                         RoomCountMax);
-    std::size_t RoomCount = RndRoomCount(RndEng);
+    std::size_t RoomCount = randomInt(RndEng, RoomCountMin, RoomCountMax);
     auto Locations = findPossibleRoomEntityLocations(Room, CheckBlocksDoor);
-    std::shuffle(Locations.begin(), Locations.end(), RndEng);
+    randomShuffle(Locations.begin(), Locations.end(), RndEng);
     auto Count = std::min(Locations.size(), RoomCount);
     for (const auto &Loc : Locations) {
       if (M.getTile(Loc.Pos) != T()) {
@@ -92,8 +94,8 @@ void addRandomRoomEntitys(Map<T, U> &M, T RoomEntity,
   }
 }
 
-template <typename T, typename U, typename RE>
-void RoomEntityPlacer<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+void RoomEntityPlacer<T, U, RE, A>::init(BuilderPass &Pass, BuilderContext &C) {
   BaseType::init(Pass, C);
   Layer = this->template getCfg<std::string>("layer");
   RoomEntity = this->template getCfg<T>("entity");
@@ -104,10 +106,10 @@ void RoomEntityPlacer<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
   RoomCountMax = this->template getCfgOr<unsigned>("room_count_max", RoomCountMax);
 }
 
-template <typename T, typename U, typename RE>
-void RoomEntityPlacer<T, U, RE>::run(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+void RoomEntityPlacer<T, U, RE, A>::run(BuilderPass &Pass, BuilderContext &C) {
   BaseType::run(Pass, C);
-  auto &Ctx = C.get<Context<T, U>>();
+  auto &Ctx = C.get<Context<T, U, A>>();
   // TODO drop the map all together and add objects to rooms instead
   addRandomRoomEntitys(Ctx.Map.get(Layer), RoomEntity, Ctx.Rooms, this->RndEng,
                        RoomPercentage, RoomCountMin, RoomCountMax,
@@ -7,21 +7,24 @@
 
 namespace ymir::Dungeon {
 
-template <typename TileType, typename TileCord, typename RndEngType>
+template <typename TileType, typename TileCord, typename RndEngType,
+          typename Alloc = std::allocator<TileType>>
 class RoomGenerator : public RandomBuilder<RndEngType> {
 public:
   static const char *Type;
 
 public:
-  using CtxType = Context<TileType, TileCord>;
+  using CtxType = Context<TileType, TileCord, Alloc>;
 
 public:
   using RandomBuilder<RndEngType>::RandomBuilder;
 
   void init(BuilderPass &Pass, BuilderContext &C) override;
-  virtual Room<TileType, TileCord> generate();
+  virtual Room<TileType, TileCord, Alloc> generate();
 
-  virtual Map<TileType, TileCord> generateRoomMap(Size2d<TileCord> Size) = 0;
+  /// Room maps are expected to use the allocator of the context
+  virtual Map<TileType, TileCord, Alloc>
+  generateRoomMap(Size2d<TileCord> Size) = 0;
 
 protected:
   CtxType &getCtx() { return BuilderBase::getCtx<CtxType>(); }
@@ -31,11 +34,11 @@ protected:
   Rect2d<TileCord> RoomMinMax;
 };
 
-template <typename T, typename U, typename RE>
-const char *RoomGenerator<T, U, RE>::Type = "room_generator";
+template <typename T, typename U, typename RE, typename A>
+const char *RoomGenerator<T, U, RE, A>::Type = "room_generator";
 
-template <typename T, typename U, typename RE>
-void RoomGenerator<T, U, RE>::init(BuilderPass &Pass, BuilderContext &Ctx) {
+template <typename T, typename U, typename RE, typename A>
+void RoomGenerator<T, U, RE, A>::init(BuilderPass &Pass, BuilderContext &Ctx) {
   RandomBuilder<RE>::init(Pass, Ctx);
   // TODO move to strings to common place
   Wall = this->template getCfg<T>("wall", "dungeon/wall");
@@ -43,8 +46,8 @@ void RoomGenerator<T, U, RE>::init(BuilderPass &Pass, BuilderContext &Ctx) {
       "room_size_min_max", "room_generator/room_size_min_max");
 }
 
-template <typename T, typename U, typename RE>
-Room<T, U> RoomGenerator<T, U, RE>::generate() {
+template <typename T, typename U, typename RE, typename A>
+Room<T, U, A> RoomGenerator<T, U, RE, A>::generate() {
   // FIXME get rid of this or at least make configurable
   for (int Attempts = 0; Attempts < 100; Attempts++) {
     const auto RoomSize = randomSize2d<U>(this->RoomMinMax, this->RndEng);
@@ -5,13 +5,17 @@
 #include <ymir/Dungeon/RandomBuilder.hpp>
 #include <ymir/Dungeon/Room.hpp>
 #include <ymir/Dungeon/RoomGenerator.hpp>
+#include <ymir/Noise.hpp>
 
 namespace ymir::Dungeon {
 
-template <typename TileType, typename TileCord, typename RandEngType>
+template <typename TileType, typename TileCord, typename RandEngType,
+          typename Alloc = std::allocator<TileType>>
 class RoomPlacer : public RandomBuilder<RandEngType> {
 public:
-  using RoomGeneratorType = RoomGenerator<TileType, TileCord, RandEngType>;
+  using RoomGeneratorType =
+      RoomGenerator<TileType, TileCord, RandEngType, Alloc>;
+  using RoomType = Room<TileType, TileCord, Alloc>;
 
 public:
   static const char *Type;
@@ -24,17 +28,16 @@ public:
   void run(BuilderPass &Pass, BuilderContext &C) override;
 
 private:
-  std::vector<std::pair<Room<TileType, TileCord> *, Dungeon::Door<TileCord> *>>
-  getSuitableDoors(const Room<TileType, TileCord> &NewRoom,
-                   std::list<Room<TileType, TileCord>> &Rooms);
-  Room<TileType, TileCord> generateInitialRoom(Map<TileType, TileCord> &M,
-                                               RandEngType &RE);
-
-  bool tryToInsertRoom(Context<TileType, TileCord> &Ctx,
-                       Dungeon::Room<TileType, TileCord> &NewRoom,
-                       Dungeon::Door<TileCord> &RoomDoor,
-                       Dungeon::Room<TileType, TileCord> &TargetRoom,
-                       Dungeon::Door<TileCord> &Door);
+  std::vector<std::pair<RoomType *, Dungeon::Door<TileCord> *>>
+  getSuitableDoors(
+      const RoomType &NewRoom,
+      typename Context<TileType, TileCord, Alloc>::RoomsType &Rooms);
+  RoomType generateInitialRoom(Map<TileType, TileCord, Alloc> &M,
+                               RandEngType &RE);
+
+  bool tryToInsertRoom(Context<TileType, TileCord, Alloc> &Ctx,
+                       RoomType &NewRoom, Dungeon::Door<TileCord> &RoomDoor,
+                       RoomType &TargetRoom, Dungeon::Door<TileCord> &Door);
 
 public:
   RoomGeneratorType *RoomGen = nullptr;
@@ -43,16 +46,17 @@ public:
   unsigned NumNewRoomAttempts = 0;
 };
 
-template <typename T, typename U, typename RE>
-const char *RoomPlacer<T, U, RE>::Type = "room_placer";
+template <typename T, typename U, typename RE, typename A>
+const char *RoomPlacer<T, U, RE, A>::Type = "room_placer";
 
-template <typename T, typename U, typename RE>
-std::vector<std::pair<Dungeon::Room<T, U> *, Dungeon::Door<U> *>>
-RoomPlacer<T, U, RE>::getSuitableDoors(const Dungeon::Room<T, U> &NewRoom,
-                                       std::list<Room<T, U>> &Rooms) {
+template <typename T, typename U, typename RE, typename A>
+std::vector<std::pair<Dungeon::Room<T, U, A> *, Dungeon::Door<U> *>>
+RoomPlacer<T, U, RE, A>::getSuitableDoors(
+    const Dungeon::Room<T, U, A> &NewRoom,
+    typename Context<T, U, A>::RoomsType &Rooms) {
   // TODO exclude doors that are already connected
   const auto Dirs = NewRoom.getOpposingDoorDirections();
-  std::vector<std::pair<Dungeon::Room<T, U> *, Dungeon::Door<U> *>> Doors;
+  std::vector<std::pair<Dungeon::Room<T, U, A> *, Dungeon::Door<U> *>> Doors;
   for (auto &Room : Rooms) {
     for (auto &Door : Room.Doors) {
       // Check if door direction is suitable if so add door
@@ -64,8 +68,9 @@ RoomPlacer<T, U, RE>::getSuitableDoors(const Dungeon::Room<T, U> &NewRoom,
   return Doors;
 }
 
-template <typename T, typename U, typename RE>
-Room<T, U> RoomPlacer<T, U, RE>::generateInitialRoom(Map<T, U> &M, RE &RndEng) {
+template <typename T, typename U, typename RE, typename A>
+Room<T, U, A> RoomPlacer<T, U, RE, A>::generateInitialRoom(Map<T, U, A> &M,
+                                                          RE &RndEng) {
   auto NewRoom = RoomGen->generate();
   const auto Size = NewRoom.M.getSize();
   const auto MapSize = M.getSize();
@@ -75,8 +80,8 @@ Room<T, U> RoomPlacer<T, U, RE>::generateInitialRoom(Map<T, U> &M, RE &RndEng) {
   return NewRoom;
 }
 
-template <typename T, typename U, typename RE>
-void RoomPlacer<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+void RoomPlacer<T, U, RE, A>::init(BuilderPass &Pass, BuilderContext &C) {
   RandomBuilder<RE>::init(Pass, C);
   auto RoomGenName = this->template getCfg<std::string>("room_generator");
   RoomGen = &this->getPass().template get<RoomGeneratorType>(RoomGenName);
@@ -85,10 +90,10 @@ void RoomPlacer<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
   NumNewRoomAttempts = this->template getCfg<unsigned>("num_new_room_attempts");
 }
 
-template <typename T, typename U, typename RE>
-void RoomPlacer<T, U, RE>::run(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+void RoomPlacer<T, U, RE, A>::run(BuilderPass &Pass, BuilderContext &C) {
   RandomBuilder<RE>::run(Pass, C);
-  auto &Ctx = C.get<Context<T, U>>();
+  auto &Ctx = C.get<Context<T, U, A>>();
   auto &M = Ctx.Map.get(Layer);
 
   // Create initial room
@@ -98,14 +103,14 @@ void RoomPlacer<T, U, RE>::run(BuilderPass &Pass, BuilderContext &C) {
   // Until we have no new room attempts left try to insert new rooms
   unsigned NewRoomAttemptsLeft = NumNewRoomAttempts;
   while (NewRoomAttemptsLeft--) {
-    ymir::Dungeon::Room<T, U> NewRoom = RoomGen->generate();
+    ymir::Dungeon::Room<T, U, A> NewRoom = RoomGen->generate();
 
     // Select a suitable room and door randomly from all available
     auto SuitableDoors = getSuitableDoors(NewRoom, Ctx.Rooms);
     if (SuitableDoors.empty()) {
       continue;
     }
-    std::shuffle(SuitableDoors.begin(), SuitableDoors.end(), this->RndEng);
+    randomShuffle(SuitableDoors.begin(), SuitableDoors.end(), this->RndEng);
 
     // Iterate over all suitable doors and try to insert the room into the
     // dungeon with a hallway starting from the door
@@ -131,12 +136,11 @@ void RoomPlacer<T, U, RE>::run(BuilderPass &Pass, BuilderContext &C) {
   }
 }
 
-template <typename T, typename U, typename RE>
-bool RoomPlacer<T, U, RE>::tryToInsertRoom(Context<T, U> &Ctx,
-                                           Dungeon::Room<T, U> &NewRoom,
-                                           Dungeon::Door<U> &RoomDoor,
-                                           Dungeon::Room<T, U> &TargetRoom,
-                                           Dungeon::Door<U> &Door) {
+template <typename T, typename U, typename RE, typename A>
+bool RoomPlacer<T, U, RE, A>::tryToInsertRoom(
+    Context<T, U, A> &Ctx, Dungeon::Room<T, U, A> &NewRoom,
+    Dungeon::Door<U> &RoomDoor, Dungeon::Room<T, U, A> &TargetRoom,
+    Dungeon::Door<U> &Door) {
   // get position for alignment
   ymir::Point2d<U> AlignmentPos = TargetRoom.Pos + Door.Pos + Door.Dir;
   for (; Ctx.Map.contains(AlignmentPos); AlignmentPos += Door.Dir) {
@@ -150,7 +154,8 @@ bool RoomPlacer<T, U, RE>::tryToInsertRoom(Context<T, U> &Ctx,
     // Create hallway between target and new room
     auto TargetDoorPos = TargetRoom.Pos + Door.Pos;
     auto NewDoorPos = NewRoom.Pos + RoomDoor.Pos;
-    auto HallwayRect = Context<T, U>::getHallwayRect(TargetDoorPos, NewDoorPos);
+    auto HallwayRect =
+        Context<T, U, A>::getHallwayRect(TargetDoorPos, NewDoorPos);
 
     // If the hallway does not fit there is no point in further checking we can
     // abort the search here, it will never fit
@@ -165,8 +170,9 @@ bool RoomPlacer<T, U, RE>::tryToInsertRoom(Context<T, U> &Ctx,
 
     Door.Used = true;
     RoomDoor.Used = true;
-    Ctx.Rooms.push_back(NewRoom); // FIXME this copies
-    Ctx.Hallways.push_back(Dungeon::Hallway<T, U>{
+    // Moving keeps the door storage, RoomDoor stays valid for the hallway
+    Ctx.Rooms.push_back(std::move(NewRoom));
+    Ctx.Hallways.push_back(Dungeon::Hallway<T, U, A>{
         HallwayRect, &Ctx.Rooms.back(), &RoomDoor, &TargetRoom, &Door});
     return true;
   }
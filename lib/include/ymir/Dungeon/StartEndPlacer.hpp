@@ -8,7 +8,8 @@
 
 namespace ymir::Dungeon {
 
-template <typename TileType, typename TileCord, typename RandomEngineType>
+template <typename TileType, typename TileCord, typename RandomEngineType,
+          typename Alloc = std::allocator<TileType>>
 class StartEndPlacer : public RandomBuilder<RandomEngineType> {
 public:
   static const char *Type;
@@ -37,11 +38,11 @@ private:
   float DistanceThres = 0.6f;
 };
 
-template <typename T, typename U, typename RE>
-const char *StartEndPlacer<T, U, RE>::Type = "start_end_placer";
+template <typename T, typename U, typename RE, typename A>
+const char *StartEndPlacer<T, U, RE, A>::Type = "start_end_placer";
 
-template <typename T, typename U, typename RE>
-void StartEndPlacer<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+void StartEndPlacer<T, U, RE, A>::init(BuilderPass &Pass, BuilderContext &C) {
   BaseType::init(Pass, C);
   Layer = this->template getCfg<std::string>("layer");
   CheckLayer = this->template getCfgOr<std::string>("check_layer", Layer);
@@ -52,9 +53,9 @@ void StartEndPlacer<T, U, RE>::init(BuilderPass &Pass, BuilderContext &C) {
       this->template getCfgOr<float>("distance_thres", DistanceThres);
 }
 
-template <typename T, typename U, typename RE>
-Point2d<U> StartEndPlacer<T, U, RE>::findFreeTileForStart() {
-  auto &Ctx = this->template getCtx<Context<T, U>>();
+template <typename T, typename U, typename RE, typename A>
+Point2d<U> StartEndPlacer<T, U, RE, A>::findFreeTileForStart() {
+  auto &Ctx = this->template getCtx<Context<T, U, A>>();
   auto &Map = Ctx.Map.get(Layer);
 
   std::vector<ymir::Point2d<U>> FreeTiles;
@@ -71,10 +72,10 @@ Point2d<U> StartEndPlacer<T, U, RE>::findFreeTileForStart() {
   return *It;
 }
 
-template <typename T, typename U, typename RE>
+template <typename T, typename U, typename RE, typename A>
 std::vector<Point2d<U>>
-StartEndPlacer<T, U, RE>::findFreeTilesForEnd(Point2d<U> StartPos) {
-  auto &Ctx = this->template getCtx<Context<T, U>>();
+StartEndPlacer<T, U, RE, A>::findFreeTilesForEnd(Point2d<U> StartPos) {
+  auto &Ctx = this->template getCtx<Context<T, U, A>>();
   auto &Map = Ctx.Map.get(Layer);
   auto &CheckMap = Ctx.Map.get(CheckLayer);
 
@@ -99,10 +100,10 @@ StartEndPlacer<T, U, RE>::findFreeTilesForEnd(Point2d<U> StartPos) {
   return PossibleEnds;
 }
 
-template <typename T, typename U, typename RE>
-void StartEndPlacer<T, U, RE>::run(BuilderPass &Pass, BuilderContext &C) {
+template <typename T, typename U, typename RE, typename A>
+void StartEndPlacer<T, U, RE, A>::run(BuilderPass &Pass, BuilderContext &C) {
   BaseType::run(Pass, C);
-  auto &Ctx = C.get<Context<T, U>>();
+  auto &Ctx = C.get<Context<T, U, A>>();
   auto &Map = Ctx.Map.get(Layer);
 
   auto StartPos = findFreeTileForStart();
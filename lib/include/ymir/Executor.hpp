@@ -0,0 +1,134 @@
+#ifndef YMIR_EXECUTOR_HPP
+#define YMIR_EXECUTOR_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <ymir/Types.hpp>
+
+namespace ymir {
+
+// Executors run a number of independent tasks, they need to provide:
+//   std::size_t getNumWorkers() const;
+//   void run(std::size_t NumTasks, Func); // calls Func(TaskIdx) per task
+// where run only returns once all tasks have completed. Map operations that
+// accept an executor split their rect into row bands and run one task per
+// band, any type following the interface can be plugged in.
+
+/// Executor running all tasks on the calling thread
+class SequentialExecutor {
+public:
+  std::size_t getNumWorkers() const { return 1; }
+
+  template <typename UnaryFunction>
+  void run(std::size_t NumTasks, UnaryFunction Func) {
+    for (std::size_t Idx = 0; Idx < NumTasks; Idx++) {
+      Func(Idx);
+    }
+  }
+};
+
+/// Executor with a fixed set of worker threads, the calling thread takes part
+/// in running the tasks. The first exception thrown by a task is rethrown from
+/// run after all tasks finished. Calls to run are serialized, running nested
+/// tasks on the same pool from within a task is not supported.
+class ThreadPoolExecutor {
+public:
+  /// Creates pool with NumWorkers threads in total including the calling
+  /// thread, zero selects the hardware concurrency
+  explicit ThreadPoolExecutor(std::size_t NumWorkers = 0);
+  ~ThreadPoolExecutor();
+
+  ThreadPoolExecutor(const ThreadPoolExecutor &) = delete;
+  ThreadPoolExecutor &operator=(const ThreadPoolExecutor &) = delete;
+
+  std::size_t getNumWorkers() const { return Threads.size() + 1; }
+
+  template <typename UnaryFunction>
+  void run(std::size_t NumTasks, UnaryFunction Func) {
+    runTasks(NumTasks, std::function<void(std::size_t)>(std::move(Func)));
+  }
+
+private:
+  void runTasks(std::size_t NumTasks,
+                const std::function<void(std::size_t)> &Func);
+  void workerLoop();
+  void processTasks(std::unique_lock<std::mutex> &Lock);
+
+private:
+  std::vector<std::thread> Threads;
+  std::mutex RunMutex;
+
+  std::mutex Mutex;
+  std::condition_variable WorkAvailable;
+  std::condition_variable WorkDone;
+  const std::function<void(std::size_t)> *Job = nullptr;
+  std::size_t NumTasks = 0;
+  std::size_t NextTask = 0;
+  std::size_t TasksDone = 0;
+  std::exception_ptr Error;
+  bool Stop = false;
+};
+
+template <typename T, typename = void> struct IsExecutor : std::false_type {};
+
+template <typename T>
+struct IsExecutor<
+    T, std::void_t<decltype(std::declval<const T &>().getNumWorkers()),
+                   decltype(std::declval<T &>().run(
+                       std::size_t(), std::declval<void (*)(std::size_t)>()))>>
+    : std::true_type {};
+
+template <typename T>
+inline constexpr bool IsExecutorV = IsExecutor<std::decay_t<T>>::value;
+
+/// Returns the row bands Rect is split into when run on Exec, the bands are
+/// ordered top to bottom. Bands other than the first start at rows that are a
+/// multiple of RowAlign.
+template <typename Executor, typename U>
+std::vector<Rect2d<U>> getRowBands(const Executor &Exec, Rect2d<U> Rect,
+                                   U RowAlign = 1) {
+  if (Rect.empty()) {
+    return {};
+  }
+  // Use a few bands per worker to balance uneven per row costs
+  const auto Rows = static_cast<std::size_t>(Rect.Size.H);
+  const auto NumBands = std::min(Rows, Exec.getNumWorkers() * 4);
+  const auto alignRow = [&Rect, RowAlign](U Row) {
+    const U Aligned = (Row + RowAlign - 1) / RowAlign * RowAlign;
+    return std::min<U>(Aligned, Rect.Pos.Y + Rect.Size.H);
+  };
+  std::vector<Rect2d<U>> Bands;
+  Bands.reserve(NumBands);
+  U Begin = Rect.Pos.Y;
+  for (std::size_t Idx = 0; Idx < NumBands; Idx++) {
+    const auto End = alignRow(
+        Rect.Pos.Y + static_cast<U>(Rows * (Idx + 1) / NumBands));
+    if (End > Begin) {
+      Bands.push_back({{Rect.Pos.X, Begin}, {Rect.Size.W, End - Begin}});
+      Begin = End;
+    }
+  }
+  return Bands;
+}
+
+/// Splits Rect into row bands and calls Func(BandIdx, Band) for each band on
+/// the executor, see getRowBands for RowAlign
+template <typename Executor, typename U, typename BinaryFunction>
+void forEachRowBand(Executor &Exec, Rect2d<U> Rect, BinaryFunction Func,
+                    U RowAlign = 1) {
+  const auto Bands = getRowBands(Exec, Rect, RowAlign);
+  Exec.run(Bands.size(),
+           [&Bands, &Func](std::size_t Idx) { Func(Idx, Bands[Idx]); });
+}
+
+} // namespace ymir
+
+#endif // #ifndef YMIR_EXECUTOR_HPP
@@ -0,0 +1,192 @@
+#ifndef YMIR_INDEXED_MAP_HPP
+#define YMIR_INDEXED_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <ymir/Map.hpp>
+#include <ymir/Types.hpp>
+
+namespace ymir {
+
+/// Classifier indexing every tile value on its own
+struct IdentityTileClass {
+  template <typename T> constexpr const T &operator()(const T &Tile) const {
+    return Tile;
+  }
+};
+
+/// Map that keeps track of the positions of all tiles per tile class, the
+/// class of a tile is given by Classifier (by default the tile value itself).
+/// Counting the tiles of a class is O(1) and enumerating them O(k). All
+/// modifications have to go through the indexed map to keep the index in
+/// sync, hence only const access to the underlying map is provided.
+///
+/// The index stores the position and bucket slot of every tile, the map thus
+/// needs roughly sizeof(TilePos) + sizeof(std::size_t) additional bytes per
+/// tile.
+template <typename T, typename U = int,
+          typename Classifier = IdentityTileClass>
+class IndexedMap {
+public:
+  using TileType = T;
+  using TileCord = U;
+  using TilePos = Point2d<TileCord>;
+  using MapType = Map<TileType, TileCord>;
+  using KeyType = std::decay_t<std::invoke_result_t<Classifier, const T &>>;
+
+public:
+  IndexedMap() = default;
+
+  explicit IndexedMap(Size2d<TileCord> Size, TileType Tile = TileType(),
+                      Classifier Classify = Classifier())
+      : M(Size), Classify(Classify) {
+    M.fill(Tile);
+    rebuildIndex();
+  }
+
+  IndexedMap(TileCord Width, TileCord Height, TileType Tile = TileType(),
+             Classifier Classify = Classifier())
+      : IndexedMap(Size2d<TileCord>{Width, Height}, Tile, Classify) {}
+
+  explicit IndexedMap(MapType Map, Classifier Classify = Classifier())
+      : M(std::move(Map)), Classify(Classify) {
+    rebuildIndex();
+  }
+
+  Size2d<TileCord> getSize() const { return M.getSize(); }
+  Rect2d<TileCord> rect() const { return M.rect(); }
+  bool contains(TilePos P) const { return M.contains(P); }
+
+  const MapType &getMap() const { return M; }
+
+  const TileType &getTile(TilePos P) const { return M.getTile(P); }
+
+  const TileType &getTileUnchecked(TilePos P) const {
+    return M.getTileUnchecked(P);
+  }
+
+  bool isTile(TilePos P, TileType Tile) const { return M.isTile(P, Tile); }
+
+  void setTile(TilePos P, TileType Tile) {
+    if (!contains(P)) {
+      throw std::out_of_range("Position outside of indexed map");
+    }
+    setTileUnchecked(P, std::move(Tile));
+  }
+
+  void setTileUnchecked(TilePos P, TileType Tile) {
+    auto &MapTile = M.getTileUnchecked(P);
+    const KeyType OldKey = Classify(MapTile);
+    const KeyType NewKey = Classify(Tile);
+    if (!(OldKey == NewKey)) {
+      removeFromBucket(OldKey, P);
+      addToBucket(NewKey, P);
+    }
+    MapTile = std::move(Tile);
+  }
+
+  void setTiles(const std::vector<TilePos> &Positions, TileType Tile) {
+    for (const auto &Pos : Positions) {
+      setTile(Pos, Tile);
+    }
+  }
+
+  void fill(TileType Tile) {
+    M.fill(std::move(Tile));
+    rebuildIndex();
+  }
+
+  void fillRect(TileType Tile, std::optional<Rect2d<TileCord>> Rect = {}) {
+    M.forEach(
+        [this, &Tile](TilePos P, const TileType &) {
+          setTileUnchecked(P, Tile);
+        },
+        Rect);
+  }
+
+  /// Copies the tiles of Other into the map with Other's top-left tile placed
+  /// at Pos
+  void merge(const MapType &Other, TilePos Pos = {0, 0}) {
+    Other.forEach([this, &Pos](TilePos P, const TileType &Tile) {
+      if (contains(P + Pos)) {
+        setTileUnchecked(P + Pos, Tile);
+      }
+    });
+  }
+
+  template <typename BinaryFunction>
+  void forEach(BinaryFunction Func,
+               std::optional<Rect2d<TileCord>> Rect = {}) const {
+    M.forEach(Func, Rect);
+  }
+
+  template <typename DirectionProvider = EightTileDirections<TileCord>>
+  std::size_t getNeighborCount(
+      TilePos P, TileType Tile,
+      DirectionProvider DirProv = DirectionProvider()) const {
+    return M.getNeighborCount(P, Tile, DirProv);
+  }
+
+  /// Returns the number of tiles of the given class in O(1)
+  std::size_t count(const KeyType &Key) const {
+    auto It = Buckets.find(Key);
+    return It == Buckets.end() ? 0 : It->second.size();
+  }
+
+  /// Returns the positions of all tiles of the given class in unspecified
+  /// order, the reference is invalidated by any modification of the map
+  const std::vector<TilePos> &positions(const KeyType &Key) const {
+    static const std::vector<TilePos> Empty;
+    auto It = Buckets.find(Key);
+    return It == Buckets.end() ? Empty : It->second;
+  }
+
+  /// Returns the positions of all tiles of the given class in row-major
+  /// order, same as Map::findTiles for the default classifier
+  std::vector<TilePos> findTiles(const KeyType &Key) const {
+    auto Result = positions(Key);
+    std::sort(Result.begin(), Result.end(), [](const auto &A, const auto &B) {
+      return A.Y < B.Y || (A.Y == B.Y && A.X < B.X);
+    });
+    return Result;
+  }
+
+private:
+  void rebuildIndex() {
+    Buckets.clear();
+    Slots = Map<std::size_t, TileCord>(M.getSize());
+    M.forEach([this](TilePos P, const TileType &Tile) {
+      addToBucket(Classify(Tile), P);
+    });
+  }
+
+  void addToBucket(const KeyType &Key, TilePos P) {
+    auto &Bucket = Buckets[Key];
+    Slots.getTileUnchecked(P) = Bucket.size();
+    Bucket.push_back(P);
+  }
+
+  void removeFromBucket(const KeyType &Key, TilePos P) {
+    auto &Bucket = Buckets[Key];
+    const auto Slot = Slots.getTileUnchecked(P);
+    const auto Moved = Bucket.back();
+    Bucket[Slot] = Moved;
+    Slots.getTileUnchecked(Moved) = Slot;
+    Bucket.pop_back();
+  }
+
+private:
+  MapType M;
+  Classifier Classify;
+  std::unordered_map<KeyType, std::vector<TilePos>> Buckets;
+  Map<std::size_t, TileCord> Slots;
+};
+
+} // namespace ymir
+
+#endif // #ifndef YMIR_INDEXED_MAP_HPP
@@ -1,33 +1,54 @@
 #ifndef YMIR_LAYERED_MAP_HPP
 #define YMIR_LAYERED_MAP_HPP
 
+#include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <ymir/Map.hpp>
 
 namespace ymir {
 
-template <typename TileType, typename TileCord = int> class LayeredMap {
+/// Map with multiple named layers of the same size. The layers and their tile
+/// storage are allocated through Alloc.
+template <typename TileType, typename TileCord = int,
+          typename Alloc = std::allocator<TileType>>
+class LayeredMap {
 public:
-  using MapType = Map<TileType, TileCord>;
+  using MapType = Map<TileType, TileCord, Alloc>;
+  using allocator_type = Alloc;
+
+private:
+  using LayerAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<MapType>;
 
 public:
   LayeredMap() = default;
 
-  LayeredMap(std::size_t NumLayers, Size2d<TileCord> Size)
-      : Size(Size), Layers(), Names() {
-    Layers.resize(NumLayers, MapType(Size));
+  LayeredMap(std::size_t NumLayers, Size2d<TileCord> Size,
+             const allocator_type &A = allocator_type())
+      : Size(Size), Layers(LayerAlloc(A)), Names() {
+    Layers.reserve(NumLayers);
+    for (std::size_t Idx = 0; Idx < NumLayers; Idx++) {
+      Layers.push_back(MapType(Size, A));
+    }
     Names.resize(NumLayers, "");
   }
 
-  LayeredMap(std::size_t NumLayers, TileCord Width, TileCord Height)
-      : LayeredMap(NumLayers, {Width, Height}) {}
+  LayeredMap(std::size_t NumLayers, TileCord Width, TileCord Height,
+             const allocator_type &A = allocator_type())
+      : LayeredMap(NumLayers, {Width, Height}, A) {}
 
-  LayeredMap(std::vector<std::string> LayerNames, Size2d<TileCord> Size)
-      : LayeredMap(LayerNames.size(), Size) {
+  LayeredMap(std::vector<std::string> LayerNames, Size2d<TileCord> Size,
+             const allocator_type &A = allocator_type())
+      : LayeredMap(LayerNames.size(), Size, A) {
     Names = std::move(LayerNames);
   }
 
+  allocator_type get_allocator() const {
+    return allocator_type(Layers.get_allocator());
+  }
+
   inline Size2d<TileCord> getSize() const { return Size; }
   std::size_t getNumLayers() const { return Layers.size(); }
   Rect2d<TileCord> rect() const { return Rect2d<TileCord>{{0, 0}, Size}; }
@@ -38,24 +59,25 @@ public:
   MapType &get(const std::string &LayerName);
   const MapType &get(const std::string &LayerName) const;
 
-  const std::vector<MapType> &getLayers() const { return Layers; }
+  const std::vector<MapType, LayerAlloc> &getLayers() const { return Layers; }
 
   MapType render(TileType Transparent = TileType()) const;
 
 private:
   Size2d<TileCord> Size;
-  std::vector<MapType> Layers;
+  std::vector<MapType, LayerAlloc> Layers;
   std::vector<std::string> Names;
 };
 
-template <typename T, typename U>
-Map<T, U> &LayeredMap<T, U>::get(const std::string &LayerName) {
-  return const_cast<Map<T, U> &>(
-      static_cast<const LayeredMap<T, U> *>(this)->get(LayerName));
+template <typename T, typename U, typename A>
+Map<T, U, A> &LayeredMap<T, U, A>::get(const std::string &LayerName) {
+  return const_cast<Map<T, U, A> &>(
+      static_cast<const LayeredMap<T, U, A> *>(this)->get(LayerName));
 }
 
-template <typename T, typename U>
-const Map<T, U> &LayeredMap<T, U>::get(const std::string &LayerName) const {
+template <typename T, typename U, typename A>
+const Map<T, U, A> &
+LayeredMap<T, U, A>::get(const std::string &LayerName) const {
   auto It = std::find(Names.begin(), Names.end(), LayerName);
   if (It != Names.end()) {
     return Layers.at(It - Names.begin());
@@ -63,9 +85,9 @@ const Map<T, U> &LayeredMap<T, U>::get(const std::string &LayerName) const {
   throw std::out_of_range("Could not find layer '" + LayerName + "'");
 }
 
-template <typename T, typename U>
-Map<T, U> LayeredMap<T, U>::render(T Transparent) const {
-  Map<T, U> Map(Size);
+template <typename T, typename U, typename A>
+Map<T, U, A> LayeredMap<T, U, A>::render(T Transparent) const {
+  Map<T, U, A> Map(Size, get_allocator());
   Map.fill(Transparent);
   for (auto const &Layer : Layers) {
     Layer.forEach([Transparent, &Map](Point2d<U> Pos, T Tile) {
@@ -78,6 +100,14 @@ Map<T, U> LayeredMap<T, U>::render(T Transparent) const {
   return Map;
 }
 
+namespace pmr {
+
+/// Layered map with all layers allocated from a std::pmr::memory_resource
+template <typename T, typename U = int>
+using LayeredMap = ymir::LayeredMap<T, U, std::pmr::polymorphic_allocator<T>>;
+
+} // namespace pmr
+
 } // namespace ymir
 
 #endif // #ifndef YMIR_LAYERED_MAP_HPP
\ No newline at end of file
@@ -0,0 +1,327 @@
+#ifndef YMIR_LIFE_RULE_HPP
+#define YMIR_LIFE_RULE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <ymir/BitMap.hpp>
+#include <ymir/Executor.hpp>
+#include <ymir/Map.hpp>
+#include <ymir/Types.hpp>
+
+namespace ymir::celat {
+
+/// Life-like birth/survival rule, bit N of Birth (Survive) is set if a dead
+/// (alive) cell with N alive neighbors is alive in the next generation
+struct LifeRule {
+  std::uint16_t Birth = 0;
+  std::uint16_t Survive = 0;
+
+  constexpr bool births(unsigned Count) const { return (Birth >> Count) & 1; }
+  constexpr bool survives(unsigned Count) const {
+    return (Survive >> Count) & 1;
+  }
+
+  /// Parses rules in B/S notation, e.g. "B3/S23" or "B5678/S45678"
+  static constexpr LifeRule parse(std::string_view Str) {
+    LifeRule Rule;
+    std::uint16_t *Mask = nullptr;
+    bool HasBirth = false, HasSurvive = false;
+    for (const char C : Str) {
+      if ((C == 'B' || C == 'b') && !HasBirth && !HasSurvive) {
+        Mask = &Rule.Birth;
+        HasBirth = true;
+      } else if ((C == 'S' || C == 's') && HasBirth && !HasSurvive) {
+        Mask = &Rule.Survive;
+        HasSurvive = true;
+      } else if (C == '/' && HasBirth && !HasSurvive) {
+        Mask = nullptr;
+      } else if (C >= '0' && C <= '8' && Mask != nullptr) {
+        *Mask |= std::uint16_t(1) << (C - '0');
+      } else {
+        throw std::runtime_error("Invalid life rule: " + std::string(Str));
+      }
+    }
+    if (!HasBirth || !HasSurvive) {
+      throw std::runtime_error("Invalid life rule: " + std::string(Str));
+    }
+    return Rule;
+  }
+};
+
+constexpr bool operator==(const LifeRule &Lhs, const LifeRule &Rhs) {
+  return Lhs.Birth == Rhs.Birth && Lhs.Survive == Rhs.Survive;
+}
+
+constexpr bool operator!=(const LifeRule &Lhs, const LifeRule &Rhs) {
+  return !(Lhs == Rhs);
+}
+
+/// Life-like rule fixed at compile time, unused neighbor counts are dropped
+/// from the kernel entirely
+template <std::uint16_t BirthMask, std::uint16_t SurviveMask>
+struct StaticLifeRule {
+  static constexpr bool births(unsigned Count) {
+    return (BirthMask >> Count) & 1;
+  }
+  static constexpr bool survives(unsigned Count) {
+    return (SurviveMask >> Count) & 1;
+  }
+};
+
+/// B5678/S45678, closes caves into smooth blobs
+using CaveLifeRule = StaticLifeRule<LifeRule::parse("B5678/S45678").Birth,
+                                    LifeRule::parse("B5678/S45678").Survive>;
+
+namespace detail {
+
+using LifeWord = BitMap<>::WordType;
+
+struct LifeCount {
+  // Bit-sliced 4 bit neighbor count, bit N of each word belongs to cell N
+  LifeWord B0, B1, B2, B3;
+
+  /// Returns mask of cells with exactly Count alive neighbors, a count of 8
+  /// is the only one with B3 set. The terms are grouped such that compilers
+  /// share them between the counts of a rule.
+  constexpr LifeWord equals(unsigned Count) const {
+    if (Count == 8) {
+      return B3;
+    }
+    const LifeWord High = (Count & 4) ? (B2 & ~B3) : ~(B2 | B3);
+    const LifeWord Low = ((Count & 2) ? B1 : ~B1) & ((Count & 1) ? B0 : ~B0);
+    return High & Low;
+  }
+};
+
+inline void halfAdd(LifeWord A, LifeWord B, LifeWord &Sum, LifeWord &Carry) {
+  Sum = A ^ B;
+  Carry = A & B;
+}
+
+inline void fullAdd(LifeWord A, LifeWord B, LifeWord C, LifeWord &Sum,
+                    LifeWord &Carry) {
+  const LifeWord AB = A ^ B;
+  Sum = AB ^ C;
+  Carry = (A & B) | (AB & C);
+}
+
+/// Adds up the eight neighbor words of 64 cells with bit-sliced adders
+inline LifeCount countNeighbors(LifeWord AboveL, LifeWord Above,
+                                LifeWord AboveR, LifeWord MidL, LifeWord MidR,
+                                LifeWord BelowL, LifeWord Below,
+                                LifeWord BelowR) {
+  LifeWord S0, C0, S1, C1, S2, C2;
+  fullAdd(AboveL, Above, AboveR, S0, C0);
+  fullAdd(BelowL, Below, BelowR, S1, C1);
+  halfAdd(MidL, MidR, S2, C2);
+
+  LifeCount Count;
+  LifeWord C3;
+  fullAdd(S0, S1, S2, Count.B0, C3);
+
+  // Four carries of weight two
+  LifeWord T, TC, TC2;
+  fullAdd(C0, C1, C2, T, TC);
+  halfAdd(T, C3, Count.B1, TC2);
+  halfAdd(TC, TC2, Count.B2, Count.B3);
+  return Count;
+}
+
+/// Returns all bits set if Cond is true, no bits otherwise
+constexpr LifeWord allIf(bool Cond) { return LifeWord(0) - LifeWord(Cond); }
+
+/// Kernel for rules known at compile time, the counts are expanded so that
+/// only the terms of the counts used by the rule remain
+template <typename RuleType> struct StaticLifeKernel {
+  template <std::size_t... Counts>
+  static LifeWord select(const LifeCount &Count, LifeWord Birth,
+                         LifeWord Survive, std::index_sequence<Counts...>) {
+    const LifeWord Born =
+        ((allIf(RuleType::births(Counts)) & Count.equals(Counts)) | ...);
+    const LifeWord Kept =
+        ((allIf(RuleType::survives(Counts)) & Count.equals(Counts)) | ...);
+    return (Birth & Born) | (Survive & Kept);
+  }
+
+  LifeWord next(const LifeCount &Count, LifeWord Cell) const {
+    return select(Count, ~Cell, Cell, std::make_index_sequence<9>());
+  }
+};
+
+/// Kernel for rules given at runtime, the rule's truth tables are looked up
+/// with a bit-sliced multiplexer selecting by the bits of the count
+class TableLifeKernel {
+public:
+  explicit TableLifeKernel(const LifeRule &Rule) {
+    for (unsigned Count = 0; Count <= 8; Count++) {
+      Birth[Count] = allIf(Rule.births(Count));
+      Survive[Count] = allIf(Rule.survives(Count));
+    }
+  }
+
+  LifeWord next(const LifeCount &Count, LifeWord Cell) const {
+    return mux(lookup(Birth, Count), lookup(Survive, Count), Cell);
+  }
+
+private:
+  /// Selects A where Sel is unset and B where it is set
+  static LifeWord mux(LifeWord A, LifeWord B, LifeWord Sel) {
+    return A ^ ((A ^ B) & Sel);
+  }
+
+  static LifeWord lookup(const LifeWord (&Table)[9], const LifeCount &C) {
+    const LifeWord M01 = mux(Table[0], Table[1], C.B0);
+    const LifeWord M23 = mux(Table[2], Table[3], C.B0);
+    const LifeWord M45 = mux(Table[4], Table[5], C.B0);
+    const LifeWord M67 = mux(Table[6], Table[7], C.B0);
+    const LifeWord M03 = mux(M01, M23, C.B1);
+    const LifeWord M47 = mux(M45, M67, C.B1);
+    return mux(mux(M03, M47, C.B2), Table[8], C.B3);
+  }
+
+private:
+  LifeWord Birth[9];
+  LifeWord Survive[9];
+};
+
+template <std::uint16_t BirthMask, std::uint16_t SurviveMask>
+StaticLifeKernel<StaticLifeRule<BirthMask, SurviveMask>>
+makeLifeKernel(const StaticLifeRule<BirthMask, SurviveMask> &) {
+  return {};
+}
+
+inline TableLifeKernel makeLifeKernel(const LifeRule &Rule) {
+  return TableLifeKernel(Rule);
+}
+
+/// Returns the row word Idx shifted so that bit N holds the left (Dir = -1) or
+/// right (Dir = 1) neighbor of cell N, cells outside of the row are dead
+inline LifeWord neighborWord(const LifeWord *Row, std::size_t Idx,
+                             std::size_t NumWords, int Dir) {
+  if (Dir < 0) {
+    return (Row[Idx] << 1) | (Idx > 0 ? Row[Idx - 1] >> 63 : 0);
+  }
+  return (Row[Idx] >> 1) | (Idx + 1 < NumWords ? Row[Idx + 1] << 63 : 0);
+}
+
+} // namespace detail
+
+/// Computes the next generation of Src into Dst for all cells within Rect,
+/// cells outside of Rect are copied. Cells outside of the map are dead.
+/// RuleType is LifeRule or a StaticLifeRule. The rows are split into bands
+/// run on Exec, each band only reads Src so the result does not depend on the
+/// executor.
+template <typename Executor, typename RuleType, typename U,
+          typename = std::enable_if_t<IsExecutorV<Executor>>>
+void stepLife(Executor &Exec, const BitMap<U> &Src, BitMap<U> &Dst,
+              const RuleType &Rule,
+              std::optional<Rect2d<typename nd<U>::type>> Rect = {}) {
+  using WordType = typename BitMap<U>::WordType;
+  constexpr U WordBits = BitMap<U>::WordBits;
+  if (Dst.getSize() != Src.getSize()) {
+    Dst.resize(Src.getSize());
+  }
+  const auto R = Src.getContained(Rect);
+  const auto NumWords = Src.getWordsPerRow();
+  const auto Size = Src.getSize();
+
+  // Per word mask of the cells within the rect, the unused bits of the last
+  // word are never part of it so births can not leak into them
+  std::vector<WordType> InRect(NumWords, 0);
+  for (U PX = R.Pos.X; PX < R.Pos.X + R.Size.W; PX++) {
+    InRect[PX / WordBits] |= WordType(1) << (PX % WordBits);
+  }
+  // Rows outside of the map read as dead
+  const std::vector<WordType> DeadRow(NumWords, 0);
+  const auto Kernel = detail::makeLifeKernel(Rule);
+
+  auto StepRow = [&](U PY) {
+    const auto *Mid = Src.rowWords(PY);
+    auto *Out = Dst.rowWords(PY);
+    if (PY < R.Pos.Y || PY >= R.Pos.Y + R.Size.H) {
+      std::copy(Mid, Mid + NumWords, Out);
+      return;
+    }
+    const auto *Above = PY > 0 ? Src.rowWords(PY - 1) : DeadRow.data();
+    const auto *Below =
+        PY + 1 < Size.H ? Src.rowWords(PY + 1) : DeadRow.data();
+
+    for (std::size_t Idx = 0; Idx < NumWords; Idx++) {
+      const auto Left = [Idx](const WordType *Row) {
+        return detail::neighborWord(Row, Idx, 0, -1);
+      };
+      const auto Right = [Idx, NumWords](const WordType *Row) {
+        return detail::neighborWord(Row, Idx, NumWords, 1);
+      };
+      const auto Count = detail::countNeighbors(
+          Left(Above), Above[Idx], Right(Above), Left(Mid), Right(Mid),
+          Left(Below), Below[Idx], Right(Below));
+
+      const WordType Cell = Mid[Idx];
+      const WordType Next = Kernel.next(Count, Cell);
+      Out[Idx] = (Next & InRect[Idx]) | (Cell & ~InRect[Idx]);
+    }
+  };
+  forEachRowBand(Exec, Src.rect(), [&StepRow](std::size_t, Rect2d<U> Band) {
+    for (auto PY = Band.Pos.Y; PY < Band.Pos.Y + Band.Size.H; PY++) {
+      StepRow(PY);
+    }
+  });
+}
+
+template <typename RuleType, typename U>
+void stepLife(const BitMap<U> &Src, BitMap<U> &Dst, const RuleType &Rule,
+              std::optional<Rect2d<typename nd<U>::type>> Rect = {}) {
+  SequentialExecutor Exec;
+  stepLife(Exec, Src, Dst, Rule, Rect);
+}
+
+/// Runs the given number of generations of the rule on BM, the executor
+/// returning from run separates the generations
+template <typename Executor, typename RuleType, typename U,
+          typename = std::enable_if_t<IsExecutorV<Executor>>>
+void runLife(Executor &Exec, BitMap<U> &BM, const RuleType &Rule,
+             std::size_t Iterations = 1,
+             std::optional<Rect2d<typename nd<U>::type>> Rect = {}) {
+  BitMap<U> Buffer(BM.getSize());
+  for (std::size_t Idx = 0; Idx < Iterations; Idx++) {
+    stepLife(Exec, BM, Buffer, Rule, Rect);
+    std::swap(BM, Buffer);
+  }
+}
+
+/// Runs the given number of generations of the rule on BM
+template <typename RuleType, typename U>
+void runLife(BitMap<U> &BM, const RuleType &Rule, std::size_t Iterations = 1,
+             std::optional<Rect2d<typename nd<U>::type>> Rect = {}) {
+  SequentialExecutor Exec;
+  runLife(Exec, BM, Rule, Iterations, Rect);
+}
+
+/// Runs the rule on the tiles of M, tiles equal to AliveTile are alive. Cells
+/// that die are set to DeadTile, cells that are born to AliveTile.
+template <typename RuleType, typename T, typename U, typename A>
+void applyLifeRule(Map<T, U, A> &M, T AliveTile, T DeadTile, const RuleType &Rule,
+                   std::size_t Iterations = 1,
+                   std::optional<Rect2d<typename nd<U>::type>> Rect = {}) {
+  auto BM = BitMap<U>::fromMap(M, AliveTile);
+  runLife(BM, Rule, Iterations, Rect);
+  M.forEach([&BM, &AliveTile, &DeadTile](Point2d<U> P, T &Tile) {
+    const bool Alive = BM.getTileUnchecked(P);
+    if (Alive) {
+      Tile = AliveTile;
+    } else if (Tile == AliveTile) {
+      Tile = DeadTile;
+    }
+  });
+}
+
+} // namespace ymir::celat
+
+#endif // #ifndef YMIR_LIFE_RULE_HPP
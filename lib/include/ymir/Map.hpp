@@ -4,36 +4,70 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
 #include <optional>
+#include <type_traits>
 #include <vector>
+#include <ymir/Executor.hpp>
+#include <ymir/MapView.hpp>
 #include <ymir/Types.hpp>
 
 namespace ymir {
 
-template <typename T, typename U = int> class Map {
+/// Row-major map of tiles. The tile storage is allocated through Alloc, e.g.
+/// ymir::pmr::Map places it in a std::pmr::memory_resource.
+template <typename T, typename U = int, typename Alloc = std::allocator<T>>
+class Map {
 public:
   using TileType = T;
   using TileCord = U;
   using TilePos = Point2d<TileCord>;
-  using DataType = std::vector<TileType>;
+  using allocator_type = Alloc;
+  using DataType = std::vector<TileType, allocator_type>;
+  using ViewType = MapView<TileType, TileCord>;
+  using ConstViewType = MapView<const TileType, TileCord>;
 
   using iterator = typename DataType::iterator;
   using const_iterator = typename DataType::const_iterator;
   using reference = typename DataType::reference;
   using const_reference = typename DataType::const_reference;
 
-  template <typename TX, typename UX>
-  friend bool operator==(const Map<TX, UX> &Lhs, const Map<TX, UX> &Rhs);
+  /// False for std::vector<bool> which does not store addressable tiles
+  static constexpr bool HasContiguousTiles = !std::is_same_v<TileType, bool>;
+
+  template <typename TX, typename UX, typename AX>
+  friend bool operator==(const Map<TX, UX, AX> &Lhs,
+                         const Map<TX, UX, AX> &Rhs);
 
 public:
   Map() = default;
 
+  explicit Map(const allocator_type &A) : Data(A) {}
+
   // TODO allow passing tile for default value when resizing
-  explicit Map(Size2d<TileCord> Size) : Size(Size) { resize(Size); }
+  explicit Map(Size2d<TileCord> Size,
+               const allocator_type &A = allocator_type())
+      : Size(Size), Data(A) {
+    resize(Size);
+  }
+
+  Map(TileCord Width, TileCord Height,
+      const allocator_type &A = allocator_type())
+      : Map(Size2d<TileCord>{Width, Height}, A) {}
+
+  /// Copies Other into storage from the given allocator
+  Map(const Map &Other, const allocator_type &A)
+      : Size(Other.Size), Data(Other.Data, A) {}
 
-  Map(TileCord Width, TileCord Height) : Map(Size2d<TileCord>{Width, Height}) {}
+  Map(Map &&Other, const allocator_type &A)
+      : Size(Other.Size), Data(std::move(Other.Data), A) {}
+
+  allocator_type get_allocator() const { return Data.get_allocator(); }
 
   Size2d<TileCord> getSize() const { return Size; }
 
@@ -46,6 +80,12 @@ public:
 
   inline void setTile(TilePos P, TileType Tile) { getTile(P) = Tile; }
 
+  /// Sets the tile at position P without bounds checking, only debug builds
+  /// assert that P is within the map
+  inline void setTileUnchecked(TilePos P, TileType Tile) {
+    getTileUnchecked(P) = Tile;
+  }
+
   void setTiles(const std::vector<ymir::Point2d<TileCord>> &TilePos,
                 TileType Tile) {
     for (auto const &Pos : TilePos) {
@@ -59,11 +99,53 @@ public:
     return Data.at(P.X + P.Y * Size.W);
   }
 
+  /// Returns the linear index of position P into the tile data
+  inline std::size_t index(TilePos P) const {
+    return static_cast<std::size_t>(P.X + P.Y * Size.W);
+  }
+
+  /// Unchecked access to the tile at position P, only debug builds assert that
+  /// P is within the map. Used by the library's own loops where the position
+  /// is known to be valid.
+  inline reference getTileUnchecked(TilePos P) {
+    assert(contains(P) && "Position out of map bounds");
+    return Data[index(P)];
+  }
+
+  inline const_reference getTileUnchecked(TilePos P) const {
+    assert(contains(P) && "Position out of map bounds");
+    return Data[index(P)];
+  }
+
+  /// Unchecked access to the tile at linear index Idx
+  inline reference operator[](std::size_t Idx) {
+    assert(Idx < Data.size() && "Index out of map bounds");
+    return Data[Idx];
+  }
+
+  inline const_reference operator[](std::size_t Idx) const {
+    assert(Idx < Data.size() && "Index out of map bounds");
+    return Data[Idx];
+  }
+
+  /// Returns pointer to the first tile of row Y, the row contains getSize().W
+  /// contiguous tiles
+  inline TileType *row(TileCord Y) {
+    assert(0 <= Y && Y < Size.H && "Row out of map bounds");
+    return Data.data() + index({0, Y});
+  }
+
+  inline const TileType *row(TileCord Y) const {
+    assert(0 <= Y && Y < Size.H && "Row out of map bounds");
+    return Data.data() + index({0, Y});
+  }
+
   inline bool isTile(TilePos P, TileType Tile) const {
-    if (static_cast<unsigned>(P.X + P.Y * Size.W) >= Data.size()) {
+    const auto Idx = index(P);
+    if (Idx >= Data.size()) {
       return false;
     }
-    return getTile(P) == Tile;
+    return Data[Idx] == Tile;
   }
 
   /// Iterates over neighbors of the current position that are within the bounds
@@ -121,9 +203,11 @@ public:
   void forEachElem(UnaryFunction Func,
                    std::optional<Rect2d<TileCord>> Rect = {}) const {
     auto R = getContained(Rect);
-    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H && PY < Size.H; PY++) {
-      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W && PX < Size.W; PX++) {
-        Func(getTile({PX, PY}));
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      auto Idx = index({R.Pos.X, PY});
+      const auto End = Idx + R.Size.W;
+      for (; Idx < End; Idx++) {
+        Func(Data[Idx]);
       }
     }
   }
@@ -132,9 +216,11 @@ public:
   void forEachElem(UnaryFunction Func,
                    std::optional<Rect2d<TileCord>> Rect = {}) {
     auto R = getContained(Rect);
-    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H && PY < Size.H; PY++) {
-      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W && PX < Size.W; PX++) {
-        Func(getTile({PX, PY}));
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      auto Idx = index({R.Pos.X, PY});
+      const auto End = Idx + R.Size.W;
+      for (; Idx < End; Idx++) {
+        Func(Data[Idx]);
       }
     }
   }
@@ -143,9 +229,10 @@ public:
   void forEach(BinaryFunction Func,
                std::optional<Rect2d<TileCord>> Rect = {}) const {
     auto R = getContained(Rect);
-    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H && PY < Size.H; PY++) {
-      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W && PX < Size.W; PX++) {
-        Func(ymir::Point2d<TileCord>{PX, PY}, getTile({PX, PY}));
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      auto Idx = index({R.Pos.X, PY});
+      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W; PX++, Idx++) {
+        Func(ymir::Point2d<TileCord>{PX, PY}, Data[Idx]);
       }
     }
   }
@@ -153,23 +240,121 @@ public:
   template <typename BinaryFunction>
   void forEach(BinaryFunction Func, std::optional<Rect2d<TileCord>> Rect = {}) {
     auto R = getContained(Rect);
-    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H && PY < Size.H; PY++) {
-      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W && PX < Size.W; PX++) {
-        Func(ymir::Point2d<TileCord>{PX, PY}, getTile({PX, PY}));
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      auto Idx = index({R.Pos.X, PY});
+      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W; PX++, Idx++) {
+        Func(ymir::Point2d<TileCord>{PX, PY}, Data[Idx]);
       }
     }
   }
 
+  /// Parallel forEachElem, the rect is split into row bands that run on the
+  /// executor. Func is called concurrently from multiple threads.
+  template <typename Executor, typename UnaryFunction,
+            typename = std::enable_if_t<IsExecutorV<Executor>>>
+  void forEachElem(Executor &Exec, UnaryFunction Func,
+                   std::optional<Rect2d<TileCord>> Rect = {}) const {
+    forEachRowBand(Exec, getContained(Rect),
+                   [this, &Func](std::size_t, Rect2d<TileCord> Band) {
+                     forEachElem(
+                         [&Func](const TileType &Tile) { Func(Tile); }, Band);
+                   });
+  }
+
+  template <typename Executor, typename UnaryFunction,
+            typename = std::enable_if_t<IsExecutorV<Executor>>>
+  void forEachElem(Executor &Exec, UnaryFunction Func,
+                   std::optional<Rect2d<TileCord>> Rect = {}) {
+    forEachRowBand(
+        Exec, getContained(Rect),
+        [this, &Func](std::size_t, Rect2d<TileCord> Band) {
+          forEachElem([&Func](TileType &Tile) { Func(Tile); }, Band);
+        },
+        getBandRowAlign());
+  }
+
+  /// Parallel forEach, the rect is split into row bands that run on the
+  /// executor. Func is called concurrently from multiple threads.
+  template <typename Executor, typename BinaryFunction,
+            typename = std::enable_if_t<IsExecutorV<Executor>>>
+  void forEach(Executor &Exec, BinaryFunction Func,
+               std::optional<Rect2d<TileCord>> Rect = {}) const {
+    forEachRowBand(Exec, getContained(Rect),
+                   [this, &Func](std::size_t, Rect2d<TileCord> Band) {
+                     forEach([&Func](TilePos P,
+                                     const TileType &Tile) { Func(P, Tile); },
+                             Band);
+                   });
+  }
+
+  template <typename Executor, typename BinaryFunction,
+            typename = std::enable_if_t<IsExecutorV<Executor>>>
+  void forEach(Executor &Exec, BinaryFunction Func,
+               std::optional<Rect2d<TileCord>> Rect = {}) {
+    forEachRowBand(
+        Exec, getContained(Rect),
+        [this, &Func](std::size_t, Rect2d<TileCord> Band) {
+          forEach([&Func](TilePos P, TileType &Tile) { Func(P, Tile); }, Band);
+        },
+        getBandRowAlign());
+  }
+
   void fill(TileType Tile) { std::fill(Data.begin(), Data.end(), Tile); }
 
   void fillRect(TileType Tile, std::optional<Rect2d<TileCord>> Rect = {}) {
-    forEachElem([&Tile](TileType &TL) { TL = Tile; }, Rect);
+    if constexpr (HasContiguousTiles) {
+      auto R = getContained(Rect);
+      if (R.empty()) {
+        return;
+      }
+      // Rows spanning the full width are contiguous, fill them at once
+      if (R.Size.W == Size.W) {
+        detail::fillTiles(row(R.Pos.Y), R.Size.W * R.Size.H, Tile);
+        return;
+      }
+      for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+        detail::fillTiles(row(PY) + R.Pos.X, R.Size.W, Tile);
+      }
+    } else {
+      // No addressable tiles, set them one by one
+      const auto R = getContained(Rect);
+      for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+        for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W; PX++) {
+          setTileUnchecked({PX, PY}, Tile);
+        }
+      }
+    }
+  }
+
+  template <typename Executor,
+            typename = std::enable_if_t<IsExecutorV<Executor>>>
+  void fillRect(Executor &Exec, TileType Tile,
+                std::optional<Rect2d<TileCord>> Rect = {}) {
+    forEachRowBand(
+        Exec, getContained(Rect),
+        [this, &Tile](std::size_t, Rect2d<TileCord> Band) {
+          fillRect(Tile, Band);
+        },
+        getBandRowAlign());
   }
 
   void replaceTile(TileType Target, TileType Replacement) {
     std::replace(Data.begin(), Data.end(), Target, Replacement);
   }
 
+  template <typename Executor,
+            typename = std::enable_if_t<IsExecutorV<Executor>>>
+  void replaceTile(Executor &Exec, TileType Target, TileType Replacement) {
+    forEachRowBand(
+        Exec, rect(),
+        [this, &Target, &Replacement](std::size_t, Rect2d<TileCord> Band) {
+          const auto Begin = Data.begin() + index(Band.Pos);
+          std::replace(Begin, Begin + Band.Size.W * Band.Size.H, Target,
+                       Replacement);
+        },
+        getBandRowAlign());
+  }
+
   std::vector<ymir::Point2d<TileCord>> findTilesNot(TileType Target) const {
     std::vector<ymir::Point2d<TileCord>> Result;
     forEach([&Target, &Result](auto Pos, const auto &Tile) {
@@ -190,8 +375,35 @@ public:
     return Result;
   }
 
-  std::vector<TileType> &getData() { return Data; }
-  const std::vector<TileType> &getData() const { return Data; }
+  /// Parallel findTiles, the result is in the same order as for findTiles
+  template <typename Executor,
+            typename = std::enable_if_t<IsExecutorV<Executor>>>
+  std::vector<ymir::Point2d<TileCord>> findTiles(Executor &Exec,
+                                                 TileType Target) const {
+    const auto Bands = getRowBands(Exec, rect());
+    std::vector<std::vector<ymir::Point2d<TileCord>>> BandResults(
+        Bands.size());
+    Exec.run(Bands.size(),
+             [this, &Target, &Bands, &BandResults](std::size_t Idx) {
+               auto &Result = BandResults[Idx];
+               forEach(
+                   [&Target, &Result](auto Pos, const auto &Tile) {
+                     if (Target == Tile) {
+                       Result.push_back(Pos);
+                     }
+                   },
+                   Bands[Idx]);
+             });
+
+    std::vector<ymir::Point2d<TileCord>> Result;
+    for (const auto &BandResult : BandResults) {
+      Result.insert(Result.end(), BandResult.begin(), BandResult.end());
+    }
+    return Result;
+  }
+
+  DataType &getData() { return Data; }
+  const DataType &getData() const { return Data; }
 
   iterator begin() { return Data.begin(); }
   iterator end() { return Data.end(); }
@@ -208,22 +420,75 @@ public:
     return {Dist % Size.W, Dist / Size.W};
   }
 
+  /// Returns a view of the given rect clipped to the map, the view is
+  /// invalidated when the map is resized
+  ViewType view(std::optional<Rect2d<TileCord>> Rect = {}) {
+    static_assert(HasContiguousTiles, "Views need addressable tiles");
+    const auto R = getContained(Rect);
+    if (R.empty()) {
+      return ViewType();
+    }
+    return ViewType(Data.data() + index(R.Pos), R.Size, Size.W);
+  }
+
+  ConstViewType view(std::optional<Rect2d<TileCord>> Rect = {}) const {
+    static_assert(HasContiguousTiles, "Views need addressable tiles");
+    const auto R = getContained(Rect);
+    if (R.empty()) {
+      return ConstViewType();
+    }
+    return ConstViewType(Data.data() + index(R.Pos), R.Size, Size.W);
+  }
+
   void merge(const Map &Other, Point2d<TileCord> Pos = {0, 0}) {
-    auto R = getContained(Rect2d<TileCord>{Pos, Other.Size});
-    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H && PY < Size.H; PY++) {
-      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W && PX < Size.W; PX++) {
-        getTile({PX, PY}) = Other.getTile({PX - Pos.X, PY - Pos.Y});
+    if constexpr (HasContiguousTiles) {
+      merge(Other.view(), Pos);
+    } else {
+      // Bit-packed tiles have no views, copy them one by one
+      auto R = getContained(Rect2d<TileCord>{Pos, Other.Size});
+      for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+        auto Idx = index({R.Pos.X, PY});
+        auto OtherIdx = Other.index({R.Pos.X - Pos.X, PY - Pos.Y});
+        const auto End = Idx + R.Size.W;
+        for (; Idx < End; Idx++, OtherIdx++) {
+          Data[Idx] = Other.Data[OtherIdx];
+        }
       }
     }
   }
 
+  void merge(ConstViewType Other, Point2d<TileCord> Pos = {0, 0}) {
+    view().merge(Other, Pos);
+  }
+
 private:
+  /// Row alignment of the bands of the parallel overloads that write tiles.
+  /// Map<bool> packs its tiles into 64 bit words (or 32 bit ones, which are
+  /// covered as well), bands start at the first tile of a word so that no two
+  /// bands write the same word.
+  TileCord getBandRowAlign() const {
+    if constexpr (HasContiguousTiles) {
+      return 1;
+    } else {
+      constexpr TileCord WordBits = 64;
+      return WordBits / std::gcd(Size.W, WordBits);
+    }
+  }
+
   Size2d<TileCord> Size;
-  std::vector<TileType> Data;
+  DataType Data;
 };
 
-template <typename T, typename U>
-std::ostream &operator<<(std::ostream &Out, const Map<T, U> &M) {
+namespace pmr {
+
+/// Map with its tiles allocated from a std::pmr::memory_resource
+template <typename T, typename U = int>
+using Map = ymir::Map<T, U, std::pmr::polymorphic_allocator<T>>;
+
+} // namespace pmr
+
+template <typename T, typename U, typename A>
+std::ostream &operator<<(std::ostream &Out, const Map<T, U, A> &M) {
   for (auto PY = 0; PY < M.getSize().H; PY++) {
     for (auto PX = 0; PX < M.getSize().W; PX++) {
       Out << M.getTile({PX, PY});
@@ -233,9 +498,18 @@ std::ostream &operator<<(std::ostream &Out, const Map<T, U> &M) {
   return Out;
 }
 
-template <typename T, typename U>
-inline bool operator==(const Map<T, U> &Lhs, const Map<T, U> &Rhs) {
-  return Lhs.Data == Rhs.Data;
+template <typename T, typename U, typename A>
+inline bool operator==(const Map<T, U, A> &Lhs, const Map<T, U, A> &Rhs) {
+  // Integral and enum tiles are equal iff their bytes are equal
+  if constexpr ((std::is_integral_v<T> || std::is_enum_v<T>) &&
+                !std::is_same_v<T, bool>) {
+    return Lhs.Data.size() == Rhs.Data.size() &&
+           (Lhs.Data.empty() ||
+            std::memcmp(Lhs.Data.data(), Rhs.Data.data(),
+                        Lhs.Data.size() * sizeof(T)) == 0);
+  } else {
+    return Lhs.Data == Rhs.Data;
+  }
 }
 
 } // namespace ymir
@@ -5,8 +5,12 @@
 
 namespace ymir {
 
-template <typename T, typename U>
-U verticalEdgeFilter(const ymir::Map<T, U> &M, ymir::Point2d<U> P, T Tile) {
+// The filters only probe the neighbors of P through isTile, the map type
+// decides how positions at its border are handled
+
+template <typename MapType, typename U = typename MapType::TileCord>
+U verticalEdgeFilter(const MapType &M, ymir::Point2d<U> P,
+                     typename MapType::TileType Tile) {
   U Value = 0;
   Value += !M.isTile({P.X - 1, P.Y + 1}, Tile);
   Value += !M.isTile({P.X + 0, P.Y + 1}, Tile);
@@ -17,8 +21,9 @@ U verticalEdgeFilter(const ymir::Map<T, U> &M, ymir::Point2d<U> P, T Tile) {
   return Value;
 }
 
-template <typename T, typename U>
-U horizontalEdgeFilter(const ymir::Map<T, U> &M, ymir::Point2d<U> P, T Tile) {
+template <typename MapType, typename U = typename MapType::TileCord>
+U horizontalEdgeFilter(const MapType &M, ymir::Point2d<U> P,
+                       typename MapType::TileType Tile) {
   U Value = 0;
   Value += !M.isTile({P.X + 1, P.Y - 1}, Tile);
   Value += !M.isTile({P.X + 1, P.Y + 0}, Tile);
@@ -31,4 +36,4 @@ U horizontalEdgeFilter(const ymir::Map<T, U> &M, ymir::Point2d<U> P, T Tile) {
 
 } // namespace ymir
 
-#endif // #ifndef YMIR_MAP_FILTER_HPP
\ No newline at end of file
+#endif // #ifndef YMIR_MAP_FILTER_HPP
@@ -0,0 +1,256 @@
+#ifndef YMIR_MAP_VIEW_HPP
+#define YMIR_MAP_VIEW_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include <ymir/Types.hpp>
+
+namespace ymir {
+
+template <typename T, typename U, typename Alloc> class Map;
+
+namespace detail {
+
+/// Copies Count tiles from Src to Dst, trivially copyable tiles are moved as
+/// raw memory. The ranges may overlap.
+template <typename T>
+inline void copyTiles(const T *Src, std::size_t Count, T *Dst) {
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    if (Count != 0) {
+      std::memmove(Dst, Src, Count * sizeof(T));
+    }
+  } else {
+    std::copy_n(Src, Count, Dst);
+  }
+}
+
+/// Sets Count tiles starting at Dst to Tile, single byte tiles use memset
+template <typename T>
+inline void fillTiles(T *Dst, std::size_t Count, const T &Tile) {
+  if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) == 1) {
+    unsigned char Byte;
+    std::memcpy(&Byte, &Tile, 1);
+    std::memset(Dst, Byte, Count);
+  } else {
+    std::fill_n(Dst, Count, Tile);
+  }
+}
+
+} // namespace detail
+
+/// Non-owning view onto a rectangle of row-major tile data, e.g. a part of a
+/// ymir::Map. Consecutive rows are Stride tiles apart. Positions are relative
+/// to the top-left tile of the view. Use a const tile type for read-only views,
+/// mutable views convert to read-only ones.
+///
+/// The view does not keep the underlying data alive, it is invalidated by
+/// anything that reallocates the viewed map (e.g. resizing it).
+template <typename T, typename U = int> class MapView {
+public:
+  using ElementType = T;
+  using TileType = std::remove_const_t<T>;
+  using TileCord = U;
+  using TilePos = Point2d<TileCord>;
+
+  using reference = T &;
+  using const_reference = const TileType &;
+
+public:
+  MapView() = default;
+
+  MapView(T *Data, Size2d<TileCord> Size, std::size_t Stride)
+      : Data(Data), Size(Size), Stride(Stride) {}
+
+  template <typename V,
+            typename = std::enable_if_t<std::is_same_v<const V, T> &&
+                                        !std::is_same_v<V, T>>>
+  MapView(const MapView<V, U> &Other)
+      : MapView(Other.data(), Other.getSize(), Other.getStride()) {}
+
+  Size2d<TileCord> getSize() const { return Size; }
+
+  /// Returns the distance in tiles between two consecutive rows
+  std::size_t getStride() const { return Stride; }
+
+  bool empty() const { return rect().empty(); }
+
+  T *data() const { return Data; }
+
+  inline constexpr Rect2d<TileCord> rect() const {
+    return Rect2d<TileCord>{{0, 0}, Size};
+  }
+
+  inline constexpr bool contains(TilePos P) const { return rect().contains(P); }
+
+  Rect2d<TileCord>
+  getContained(std::optional<Rect2d<TileCord>> Rect = {}) const {
+    if (Rect) {
+      return rect() & *Rect;
+    }
+    return rect();
+  }
+
+  /// Returns the offset of position P from the first tile of the view
+  inline std::size_t index(TilePos P) const {
+    return static_cast<std::size_t>(P.Y) * Stride +
+           static_cast<std::size_t>(P.X);
+  }
+
+  inline reference getTile(TilePos P) const {
+    if (!contains(P)) {
+      throw std::out_of_range("Position outside of map view");
+    }
+    return Data[index(P)];
+  }
+
+  inline reference getTileUnchecked(TilePos P) const {
+    assert(contains(P) && "Position out of map view bounds");
+    return Data[index(P)];
+  }
+
+  inline void setTile(TilePos P, TileType Tile) const { getTile(P) = Tile; }
+
+  inline void setTileUnchecked(TilePos P, TileType Tile) const {
+    getTileUnchecked(P) = Tile;
+  }
+
+  inline bool isTile(TilePos P, TileType Tile) const {
+    return contains(P) && Data[index(P)] == Tile;
+  }
+
+  /// Returns pointer to the first tile of row Y, the row contains getSize().W
+  /// contiguous tiles
+  inline T *row(TileCord Y) const {
+    assert(0 <= Y && Y < Size.H && "Row out of map view bounds");
+    return Data + static_cast<std::size_t>(Y) * Stride;
+  }
+
+  /// Returns a view of the given rect of this view, clipped to its bounds
+  MapView subview(Rect2d<TileCord> Rect) const {
+    const auto R = getContained(Rect);
+    if (R.empty()) {
+      return MapView();
+    }
+    return MapView(Data + index(R.Pos), R.Size, Stride);
+  }
+
+  template <typename BinaryFunction,
+            typename DirectionProvider = EightTileDirections<TileCord>>
+  void checkNeighbors(
+      TilePos P, BinaryFunction Func,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) const {
+    DirectionProvider::forEach(*this, P, Func);
+  }
+
+  template <typename DirectionProvider = EightTileDirections<TileCord>>
+  std::size_t getNeighborCount(
+      TilePos P, TileType Tile,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) const {
+    std::size_t Count = 0;
+    for (const auto &Dir : DirectionProvider::get()) {
+      Count += isTile(P + Dir, Tile);
+    }
+    return Count;
+  }
+
+  template <typename DirectionProvider = EightTileDirections<TileCord>>
+  std::size_t getNotNeighborCount(
+      TilePos P, TileType Tile,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) const {
+    return DirectionProvider::Directions.size() -
+           getNeighborCount(P, Tile, DirProv);
+  }
+
+  template <typename UnaryFunction>
+  void forEachElem(UnaryFunction Func,
+                   std::optional<Rect2d<TileCord>> Rect = {}) const {
+    auto R = getContained(Rect);
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      T *Row = row(PY) + R.Pos.X;
+      for (TileCord PX = 0; PX < R.Size.W; PX++) {
+        Func(Row[PX]);
+      }
+    }
+  }
+
+  template <typename BinaryFunction>
+  void forEach(BinaryFunction Func,
+               std::optional<Rect2d<TileCord>> Rect = {}) const {
+    auto R = getContained(Rect);
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      T *Row = row(PY);
+      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W; PX++) {
+        Func(TilePos{PX, PY}, Row[PX]);
+      }
+    }
+  }
+
+  void fill(TileType Tile) const { fillRect(Tile); }
+
+  void fillRect(TileType Tile,
+                std::optional<Rect2d<TileCord>> Rect = {}) const {
+    auto R = getContained(Rect);
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      detail::fillTiles(row(PY) + R.Pos.X, R.Size.W, Tile);
+    }
+  }
+
+  std::vector<TilePos> findTiles(TileType Target) const {
+    std::vector<TilePos> Result;
+    forEach([&Target, &Result](auto Pos, const auto &Tile) {
+      if (Target == Tile) {
+        Result.push_back(Pos);
+      }
+    });
+    return Result;
+  }
+
+  /// Copies the tiles of Other into this view with Other's top-left tile
+  /// placed at Pos, tiles outside of this view are skipped
+  void merge(MapView<const TileType, TileCord> Other,
+             TilePos Pos = {0, 0}) const {
+    auto R = getContained(Rect2d<TileCord>{Pos, Other.getSize()});
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      const TileType *Src = Other.row(PY - Pos.Y) + (R.Pos.X - Pos.X);
+      detail::copyTiles(Src, R.Size.W, row(PY) + R.Pos.X);
+    }
+  }
+
+  /// Returns an owning copy of the viewed tiles
+  template <typename MapType =
+                Map<TileType, TileCord, std::allocator<TileType>>>
+  MapType toMap() const {
+    MapType M(Size);
+    forEach([&M](TilePos P, const TileType &Tile) {
+      M.setTileUnchecked(P, Tile);
+    });
+    return M;
+  }
+
+private:
+  T *Data = nullptr;
+  Size2d<TileCord> Size;
+  std::size_t Stride = 0;
+};
+
+template <typename T, typename U>
+std::ostream &operator<<(std::ostream &Out, const MapView<T, U> &MV) {
+  for (auto PY = 0; PY < MV.getSize().H; PY++) {
+    for (auto PX = 0; PX < MV.getSize().W; PX++) {
+      Out << MV.getTileUnchecked({PX, PY});
+    }
+    Out << '\n';
+  }
+  return Out;
+}
+
+} // namespace ymir
+
+#endif // #ifndef YMIR_MAP_VIEW_HPP
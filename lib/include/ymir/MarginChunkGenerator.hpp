@@ -0,0 +1,137 @@
+#ifndef YMIR_MARGIN_CHUNK_GENERATOR_HPP
+#define YMIR_MARGIN_CHUNK_GENERATOR_HPP
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+#include <ymir/ChunkedMap.hpp>
+#include <ymir/Map.hpp>
+#include <ymir/Types.hpp>
+
+namespace ymir {
+
+/// Chunk generator for a ChunkedMap whose chunks run generations reading the
+/// eight neighbors of each tile, e.g. the generations of a synchronous
+/// cellular automaton. A generation only gives the unbounded result for tiles
+/// at least one tile away from the edge of the map it runs on, so a chunk
+/// needs a margin of one tile per generation left to run.
+///
+/// The generations start from a base layer that must only depend on the world
+/// position of a tile, e.g. fillRectCoordRandom with the origin as offset.
+/// Adjacent chunks then match bit for bit across their borders.
+///
+/// The base layer and every intermediate generation are kept in LRU caches of
+/// their own, so each chunk of each generation is generated only once and
+/// adjacent chunks share their margins. Generation k is stored shifted by
+/// Margin - k tiles towards the bottom-right. A chunk of generation k then
+/// reads its own chunk of generation k-1 plus a band of two tiles from the
+/// chunks above and to the left of it, which keeps the chunks generated ahead
+/// of the accessed ones to one ring per generation on the top-left side.
+///
+/// The generations must not depend on the scan order, in-place updates like
+/// celat::replace carry changes across the whole row and never line up.
+template <typename T, typename U = int> class MarginChunkGenerator {
+public:
+  using TileType = T;
+  using TileCord = U;
+  using TilePos = Point2d<TileCord>;
+  using BaseMapType = ChunkedMap<TileType, TileCord>;
+  using ChunkType = typename BaseMapType::ChunkType;
+
+  /// Fills the chunk with the base layer given the world position of its
+  /// top-left tile
+  using BaseFunc = typename BaseMapType::GeneratorFunc;
+
+  /// Runs a single generation on the chunk extended by a margin of one tile
+  using GenerationFunc = std::function<void(ChunkType &)>;
+
+public:
+  /// The memory budget is split evenly between the base layer and the
+  /// intermediate generations
+  MarginChunkGenerator(
+      Size2d<TileCord> ChunkSize, BaseFunc Base,
+      std::vector<GenerationFunc> Generations,
+      std::size_t CacheMemoryBudget = BaseMapType::DefaultMemoryBudget)
+      : Generations(std::move(Generations)) {
+    if (ChunkSize.W <= 0 || ChunkSize.H <= 0) {
+      throw std::out_of_range("Invalid chunk size for chunk generator");
+    }
+    const auto NumLevels = std::max<std::size_t>(1, this->Generations.size());
+    const auto LevelBudget = CacheMemoryBudget / NumLevels;
+    Levels.reserve(NumLevels);
+    // Level K is stored shifted by Margin - K tiles, see generate()
+    const TilePos BaseShift{getMargin(), getMargin()};
+    Levels.emplace_back(
+        ChunkSize,
+        [Base = std::move(Base), BaseShift](ChunkType &Chunk, TilePos Origin) {
+          Base(Chunk, Origin + BaseShift);
+        },
+        LevelBudget);
+    for (std::size_t Gen = 1; Gen < NumLevels; Gen++) {
+      Levels.emplace_back(
+          ChunkSize,
+          [this, Gen](ChunkType &Chunk, TilePos Origin) {
+            generate(Gen, Chunk, Origin);
+          },
+          LevelBudget);
+    }
+    Scratch.resize(NumLevels);
+  }
+
+  // The cached levels call back into the generator
+  MarginChunkGenerator(const MarginChunkGenerator &) = delete;
+  MarginChunkGenerator &operator=(const MarginChunkGenerator &) = delete;
+
+  /// Returns the margin around a chunk needed by all generations
+  TileCord getMargin() const {
+    return static_cast<TileCord>(Generations.size());
+  }
+
+  /// Returns the cached chunks after the first Gen generations, the tile at P
+  /// holds the world position P + Margin - Gen. The last generation is only
+  /// stored by the chunked map using the generator.
+  BaseMapType &getGenerationMap(std::size_t Gen) { return Levels.at(Gen); }
+
+  /// Generates the chunk with its top-left tile at the world position Origin,
+  /// pass std::ref of the generator to the ChunkedMap
+  void operator()(ChunkType &Chunk, TilePos Origin) {
+    if (Generations.empty()) {
+      Levels.front().copyRect({Origin, Chunk.getSize()}, Chunk.view());
+      return;
+    }
+    generate(Generations.size(), Chunk, Origin);
+  }
+
+private:
+  /// Runs generation Gen on the chunk extended by one tile of generation
+  /// Gen - 1 and crops the result into Chunk. Origin is shifted like the
+  /// chunks of generation Gen, the previous generation is shifted one more.
+  void generate(std::size_t Gen, ChunkType &Chunk, TilePos Origin) {
+    const auto Size = Chunk.getSize();
+    const Size2d<TileCord> ExtSize{Size.W + 2, Size.H + 2};
+    // Loading the previous generation may generate chunks of the levels
+    // below it, each level needs its own scratch map
+    auto &Extended = Scratch[Gen - 1];
+    if (Extended.getSize() != ExtSize) {
+      Extended = ChunkType(ExtSize);
+    }
+    Levels[Gen - 1].copyRect({Origin - TilePos{2, 2}, ExtSize},
+                             Extended.view());
+    Generations[Gen - 1](Extended);
+    Chunk.merge(Extended.view(Rect2d<TileCord>{{1, 1}, Size}));
+  }
+
+private:
+  std::vector<GenerationFunc> Generations;
+
+  /// Levels[K] caches the chunks after K generations, Levels[0] is the base
+  std::vector<BaseMapType> Levels;
+
+  /// Chunk extended by one tile for each generation, reused between chunks
+  std::vector<ChunkType> Scratch;
+};
+
+} // namespace ymir
+
+#endif // #ifndef YMIR_MARGIN_CHUNK_GENERATOR_HPP
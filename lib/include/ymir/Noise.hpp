@@ -1,9 +1,18 @@
 #ifndef YMIR_NOISE_HPP
 #define YMIR_NOISE_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <random>
+#include <type_traits>
+#include <vector>
+#include <ymir/BitMap.hpp>
+#include <ymir/Executor.hpp>
 #include <ymir/Map.hpp>
+#include <ymir/MapView.hpp>
 #include <ymir/Types.hpp>
 
 namespace ymir {
@@ -14,25 +23,277 @@ public:
   using result_type = Uint64;
 
   inline Uint64 operator()() {
-    WyHash += 0x60bee2bee120fc15;
+    WyHash += Increment;
+    return mix(WyHash);
+  }
+
+  static constexpr inline  Uint64 min() { return 0; }
+
+  static constexpr inline Uint64 max() { return static_cast<Uint64>(-1); }
+
+  inline void seed(Uint64 Seed) { WyHash = Seed; }
+
+  /// Writes the next N values to Out, the same values N calls would return.
+  /// The state is a counter, four values are computed per iteration without
+  /// depending on each other so that their multiplications overlap.
+  void fill(Uint64 *Out, std::size_t N) {
+    const std::size_t End = N - N % 4;
+    for (std::size_t Idx = 0; Idx < End; Idx += 4) {
+      Out[Idx] = mix(WyHash + Increment);
+      Out[Idx + 1] = mix(WyHash + 2 * Increment);
+      Out[Idx + 2] = mix(WyHash + 3 * Increment);
+      Out[Idx + 3] = mix(WyHash + 4 * Increment);
+      WyHash += 4 * Increment;
+    }
+    for (std::size_t Idx = End; Idx < N; Idx++) {
+      WyHash += Increment;
+      Out[Idx] = mix(WyHash);
+    }
+  }
+
+  /// Skips the next N values in constant time
+  inline void discard(Uint64 N) { WyHash += N * Increment; }
+
+  /// Returns an engine for the sub-stream StreamId, the engine itself is not
+  /// advanced. Each sub-stream starts at a pseudo random position of the
+  /// sequence, a hash of the current state and the id, e.g. workers can
+  /// split a shared engine by their index and draw reproducible numbers
+  /// without locking. Hashing instead of offsetting the state keeps nested
+  /// splits and splits of an advanced engine unrelated to earlier streams.
+  /// Sub-streams only overlap if they draw close to 2^64 divided by the
+  /// number of streams values.
+  WyHashRndEng split(Uint64 StreamId) const {
+    WyHashRndEng Sub;
+    Sub.seed(mix(WyHash ^ mix((StreamId + 1) * Increment)));
+    return Sub;
+  }
+
+private:
+  static constexpr Uint64 Increment = 0x60bee2bee120fc15;
+
+  static inline Uint64 mix(Uint64 State) {
     Uint128 Tmp;
-    Tmp = (Uint128)WyHash * 0xa3b195354a39b70d;
+    Tmp = (Uint128)State * 0xa3b195354a39b70d;
     Uint64 M1 = Uint64((Tmp >> 64) ^ Tmp);
     Tmp = (Uint128)M1 * 0x1b03738712fad5c9;
     Uint64 M2 = Uint64((Tmp >> 64) ^ Tmp);
     return M2;
   }
 
-  static constexpr inline  Uint64 min() { return 0; }
+  Uint64 WyHash = 0;
+};
 
-  static constexpr inline Uint64 max() { return static_cast<Uint64>(-1); }
+/// Counter-based random numbers, the value of a tile is a hash of the seed and
+/// its coordinates instead of the next value of a sequence. Tiles can be drawn
+/// in any order, e.g. chunk by chunk or from several threads, and always get
+/// the same value. Coordinates are taken modulo 2^32.
+class CoordHash {
+public:
+  constexpr explicit CoordHash(Uint64 Seed = 0)
+      : Seed(Seed), KeyX(std::uint32_t(splitMix(Seed))),
+        KeyY(std::uint32_t(splitMix(Seed) >> 32)) {}
 
-  inline void seed(Uint64 Seed) { WyHash = Seed; }
+  constexpr Uint64 getSeed() const { return Seed; }
+
+  /// Returns 32 random bits for the tile at X, Y
+  constexpr std::uint32_t operator()(std::int64_t X, std::int64_t Y) const {
+    return mix(mix(std::uint32_t(X) ^ KeyX) ^ rowKey(Y));
+  }
+
+  /// Writes the values of the N tiles starting at X, Y along the row to Out,
+  /// Out[Idx] = (*this)(X + Idx, Y). Eight tiles are hashed at once with
+  /// AVX2 if the CPU supports it.
+  void fillRow(std::int64_t X, std::int64_t Y, std::uint32_t *Out,
+               std::size_t N) const;
 
 private:
-  Uint64 WyHash = 0;
+  /// Derives the two 32 bit keys from the seed, see
+  /// https://prng.di.unimi.it/splitmix64.c
+  static constexpr Uint64 splitMix(Uint64 X) {
+    X += 0x9e3779b97f4a7c15;
+    X = (X ^ (X >> 30)) * 0xbf58476d1ce4e5b9;
+    X = (X ^ (X >> 27)) * 0x94d049bb133111eb;
+    return X ^ (X >> 31);
+  }
+
+  /// Bijective 32 bit integer hash "lowbias32", see
+  /// https://nullprogram.com/blog/2018/07/31/
+  static constexpr std::uint32_t mix(std::uint32_t X) {
+    X ^= X >> 16;
+    X *= 0x7feb352d;
+    X ^= X >> 15;
+    X *= 0x846ca68b;
+    X ^= X >> 16;
+    return X;
+  }
+
+  constexpr std::uint32_t rowKey(std::int64_t Y) const {
+    return mix(std::uint32_t(Y) ^ KeyY);
+  }
+
+  Uint64 Seed;
+  std::uint32_t KeyX;
+  std::uint32_t KeyY;
 };
 
+namespace detail {
+
+constexpr int floorLog2(Uint64 Value) {
+  int Log = 0;
+  while (Value >>= 1) {
+    Log++;
+  }
+  return Log;
+}
+
+template <typename RE, typename = void> struct HasFill : std::false_type {};
+
+template <typename RE>
+struct HasFill<RE, std::void_t<decltype(std::declval<RE &>().fill(
+                       std::declval<Uint64 *>(), std::size_t()))>>
+    : std::true_type {};
+
+/// Returns 64 random bits. Engines with a range of 32 or 64 bits are used
+/// directly, others are combined from the largest power of two below their
+/// range with rejection. The result only depends on the values of the engine
+/// and not on the standard library.
+template <typename RE> Uint64 randomBits64(RE &RndEng) {
+  using ResultType = typename RE::result_type;
+  if constexpr (RE::min() == 0 && RE::max() == ~Uint64(0)) {
+    return RndEng();
+  } else if constexpr (RE::min() == 0 && RE::max() == 0xffffffff) {
+    const Uint64 High = Uint64(ResultType(RndEng())) << 32;
+    return High | ResultType(RndEng());
+  } else {
+    constexpr Uint64 Range = Uint64(RE::max() - RE::min()) + 1;
+    constexpr int Bits = floorLog2(Range);
+    constexpr Uint64 Mask = (Uint64(1) << Bits) - 1;
+    // Values from the largest multiple of 2^Bits on would be biased
+    constexpr Uint64 Limit = Range - Range % (Mask + 1);
+    Uint64 Result = 0;
+    for (int Got = 0; Got < 64; Got += Bits) {
+      Uint64 Value;
+      do {
+        Value = Uint64(RndEng() - RE::min());
+      } while (Value >= Limit);
+      Result = (Result << Bits) | (Value & Mask);
+    }
+    return Result;
+  }
+}
+
+/// Writes N results of randomBits64 to Out, in bulk if the engine can
+template <typename RE>
+void fillRandomBits64(RE &RndEng, Uint64 *Out, std::size_t N) {
+  if constexpr (HasFill<RE>::value &&
+                std::is_same_v<typename RE::result_type, Uint64> &&
+                RE::min() == 0 && RE::max() == ~Uint64(0)) {
+    RndEng.fill(Out, N);
+  } else {
+    for (std::size_t Idx = 0; Idx < N; Idx++) {
+      Out[Idx] = randomBits64(RndEng);
+    }
+  }
+}
+
+/// Maps 64 random bits to [0, Range) with Lemire's nearly divisionless
+/// method, see https://arxiv.org/abs/1805.10941. Draws of the engine are only
+/// rejected with a chance of Range / 2^64.
+template <typename RE>
+Uint64 boundRandomBits(RE &RndEng, Uint64 Bits, Uint64 Range) {
+  Uint128 Product = Uint128(Bits) * Range;
+  Uint64 Low = Uint64(Product);
+  if (Low < Range) {
+    const Uint64 Thres = (0 - Range) % Range;
+    while (Low < Thres) {
+      Product = Uint128(randomBits64(RndEng)) * Range;
+      Low = Uint64(Product);
+    }
+  }
+  return Uint64(Product >> 64);
+}
+
+/// Maps 64 random bits to [0, 1) from their upper 24 bits
+inline float bitsToFloat(Uint64 Bits) {
+  return float(Bits >> 40) * (1.0f / 16777216.0f);
+}
+
+} // namespace detail
+
+// The samplers below give the same values for the same engine with every
+// compiler and standard library, unlike the std distributions.
+
+/// Returns a uniformly distributed integer in [0, Range), Range must not be 0
+template <typename RE> Uint64 randomBounded(RE &RndEng, Uint64 Range) {
+  return detail::boundRandomBits(RndEng, detail::randomBits64(RndEng), Range);
+}
+
+/// Returns a uniformly distributed integer in [Min, Max]
+template <typename T, typename RE> T randomInt(RE &RndEng, T Min, T Max) {
+  static_assert(std::is_integral_v<T>, "Integral type required");
+  const Uint64 Range = Uint64(Max) - Uint64(Min) + 1;
+  if (Range == 0) {
+    return T(detail::randomBits64(RndEng));
+  }
+  return T(Uint64(Min) + randomBounded(RndEng, Range));
+}
+
+/// Returns a uniformly distributed float in [0, 1), all values are multiples
+/// of 2^-24
+template <typename RE> float randomFloat(RE &RndEng) {
+  return detail::bitsToFloat(detail::randomBits64(RndEng));
+}
+
+/// Returns a uniformly distributed float in [Begin, End)
+template <typename RE> float randomFloat(RE &RndEng, float Begin, float End) {
+  return Begin + (End - Begin) * randomFloat(RndEng);
+}
+
+/// Writes N integers in [Min, Max] to Out, the same as N calls of randomInt
+/// unless a draw is rejected. The random words are drawn in bulk if the
+/// engine supports it.
+template <typename T, typename RE>
+void fillRandomInt(RE &RndEng, T Min, T Max, T *Out, std::size_t N) {
+  static_assert(std::is_integral_v<T>, "Integral type required");
+  const Uint64 Range = Uint64(Max) - Uint64(Min) + 1;
+  std::array<Uint64, 64> Bits;
+  for (std::size_t Idx = 0; Idx < N; Idx += Bits.size()) {
+    const auto Count = std::min(Bits.size(), N - Idx);
+    detail::fillRandomBits64(RndEng, Bits.data(), Count);
+    for (std::size_t Pos = 0; Pos < Count; Pos++) {
+      const auto Value =
+          Range == 0 ? Bits[Pos]
+                     : detail::boundRandomBits(RndEng, Bits[Pos], Range);
+      Out[Idx + Pos] = T(Uint64(Min) + Value);
+    }
+  }
+}
+
+/// Writes N floats in [0, 1) to Out, the same as N calls of randomFloat
+template <typename RE>
+void fillRandomFloat(RE &RndEng, float *Out, std::size_t N) {
+  std::array<Uint64, 64> Bits;
+  for (std::size_t Idx = 0; Idx < N; Idx += Bits.size()) {
+    const auto Count = std::min(Bits.size(), N - Idx);
+    detail::fillRandomBits64(RndEng, Bits.data(), Count);
+    for (std::size_t Pos = 0; Pos < Count; Pos++) {
+      Out[Idx + Pos] = detail::bitsToFloat(Bits[Pos]);
+    }
+  }
+}
+
+/// Shuffles the range with the Fisher-Yates shuffle, unlike std::shuffle the
+/// order only depends on the engine
+template <typename Iter, typename RE>
+void randomShuffle(Iter Begin, Iter End, RE &RndEng) {
+  const auto Size = std::distance(Begin, End);
+  for (auto Idx = Size - 1; Idx > 0; Idx--) {
+    const auto Other = randomBounded(RndEng, Uint64(Idx) + 1);
+    std::iter_swap(std::next(Begin, Idx),
+                   std::next(Begin, static_cast<decltype(Idx)>(Other)));
+  }
+}
+
 // REMOVE this just use std::uniform_real_distribution
 template <typename RndEngType, typename ValueType = float> class UniformRndEng {
 public:
@@ -48,55 +309,167 @@ private:
 
 template <typename T, typename RE>
 Size2d<T> randomSize2d(Rect2d<T> Rect, RE &RndEng) {
-  std::uniform_real_distribution<float> Uni(0, 1);
-  return {Rect.Pos.X + static_cast<T>(Uni(RndEng) * Rect.Size.W),
-          Rect.Pos.Y + static_cast<T>(Uni(RndEng) * Rect.Size.H)};
+  const auto W = static_cast<T>(randomFloat(RndEng) * Rect.Size.W);
+  const auto H = static_cast<T>(randomFloat(RndEng) * Rect.Size.H);
+  return {Rect.Pos.X + W, Rect.Pos.Y + H};
 }
 
 template <typename T, typename RE>
 Point2d<T> randomPoint2d(Rect2d<T> Rect, RE &RndEng) {
-  std::uniform_real_distribution<float> Uni(0, 1);
-  return {Rect.Pos.X + static_cast<T>(Uni(RndEng) * Rect.Size.W),
-          Rect.Pos.Y + static_cast<T>(Uni(RndEng) * Rect.Size.H)};
+  const auto X = static_cast<T>(randomFloat(RndEng) * Rect.Size.W);
+  const auto Y = static_cast<T>(randomFloat(RndEng) * Rect.Size.H);
+  return {Rect.Pos.X + X, Rect.Pos.Y + Y};
 }
 
-template <typename TileType, typename RndGenType, typename U>
-void fillRectRandom(Map<TileType, U> &M, TileType Tile, float Chance,
+/// Draws 64 Bernoulli outcomes with the same chance at once, bit Idx of the
+/// result is set with the given chance. The chance is a 32 bit fixed point
+/// number, each outcome compares a random number against it bit by bit from
+/// the most significant bit on. The random bits of the 64 numbers are drawn
+/// one word per bit position, only until all 64 comparisons are decided. This
+/// takes about eight words and fewer for chances like 0.5 or 0.25 whose fixed
+/// point bits end early.
+class BernoulliBits {
+public:
+  explicit BernoulliBits(float Chance)
+      : Chance(Uint64(std::clamp(double(Chance), 0.0, 1.0) * 4294967296.0)) {}
+
+  template <typename RE> Uint64 operator()(RE &RndEng) const {
+    if (Chance >= (Uint64(1) << 32)) {
+      return ~Uint64(0);
+    }
+    Uint64 Less = 0, Undecided = ~Uint64(0);
+    for (int Bit = 31; Bit >= 0 && Undecided != 0; Bit--) {
+      // Lanes still equal to all remaining zero bits can not become less
+      if ((Chance & ((Uint64(2) << Bit) - 1)) == 0) {
+        break;
+      }
+      const Uint64 Rnd = detail::randomBits64(RndEng);
+      if ((Chance >> Bit) & 1) {
+        Less |= Undecided & ~Rnd;
+        Undecided &= Rnd;
+      } else {
+        Undecided &= ~Rnd;
+      }
+    }
+    return Less;
+  }
+
+private:
+  /// The chance scaled by 2^32
+  Uint64 Chance;
+};
+
+template <typename TileType, typename RndGenType, typename U, typename A>
+void fillRectRandom(Map<TileType, U, A> &M, TileType Tile, float Chance,
                     RndGenType &RndGen,
                     std::optional<Rect2d<typename nd<U>::type>> Rect = {}) {
-  std::uniform_int_distribution<int> Uni(0, 1000000);
-  int IntChance = Chance * 1000000;
-  M.forEachElem(
-      [&Uni, &RndGen, IntChance, Tile](TileType &MapTile) {
-        if (Uni(RndGen) < IntChance) {
-          MapTile = Tile;
+  const auto R = M.getContained(Rect);
+  const BernoulliBits Bernoulli(Chance);
+  for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+    for (U PX = 0; PX < R.Size.W; PX += 64) {
+      const auto Bits = Bernoulli(RndGen);
+      const auto End = std::min<U>(64, R.Size.W - PX);
+      if constexpr (Map<TileType, U, A>::HasContiguousTiles) {
+        TileType *Row = M.row(PY) + R.Pos.X + PX;
+        for (U Idx = 0; Idx < End; Idx++) {
+          // Select without a branch, the outcomes are unpredictable by design
+          const TileType Choices[2] = {Row[Idx], Tile};
+          Row[Idx] = Choices[(Bits >> Idx) & 1];
         }
-      },
-      Rect);
+      } else {
+        for (U Idx = 0; Idx < End; Idx++) {
+          if ((Bits >> Idx) & 1) {
+            M.setTileUnchecked({R.Pos.X + PX + Idx, PY}, Tile);
+          }
+        }
+      }
+    }
+  }
+}
+
+/// Sets each tile of the rect to Tile with the given chance, 64 tiles of a
+/// row are drawn at once
+template <typename RndGenType, typename U>
+void fillRectRandom(BitMap<U> &BM, bool Tile, float Chance, RndGenType &RndGen,
+                    std::optional<Rect2d<typename nd<U>::type>> Rect = {}) {
+  constexpr U WordBits = BitMap<U>::WordBits;
+  const auto R = BM.getContained(Rect);
+  const BernoulliBits Bernoulli(Chance);
+  for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+    auto *Words = BM.rowWords(PY);
+    for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W;) {
+      // Mask of bits [PX, min(word end, rect end)) in the current word
+      const auto Bit = PX % WordBits;
+      const auto NumBits =
+          std::min<U>(WordBits - Bit, R.Pos.X + R.Size.W - PX);
+      const auto Mask =
+          (NumBits == WordBits ? ~Uint64(0) : ((Uint64(1) << NumBits) - 1))
+          << Bit;
+      const auto Bits = Bernoulli(RndGen) & Mask;
+      auto &Word = Words[PX / WordBits];
+      Word = Tile ? (Word | Bits) : (Word & ~Bits);
+      PX += NumBits;
+    }
+  }
 }
 
-template <typename TileType, typename RndGenType, typename U>
-void fillRectSeedRandom(Map<TileType, U> &M, TileType Tile, float Chance,
+template <typename TileType, typename RndGenType, typename U, typename A>
+void fillRectSeedRandom(Map<TileType, U, A> &M, TileType Tile, float Chance,
                         RndGenType &RndGen,
                         std::optional<Rect2d<typename nd<U>::type>> Rect = {},
                         Point2d<U> Offset = {0, 0}) {
-  std::uniform_int_distribution<int> Uni(0, 1000000);
-  int IntChance = Chance * 1000000;
+  const int IntChance = Chance * 1000000;
   M.forEach(
-      [&Uni, &RndGen, IntChance, Tile, Offset](Point2d<U> P,
-                                               TileType &MapTile) {
+      [&RndGen, IntChance, Tile, Offset](Point2d<U> P, TileType &MapTile) {
         RndGen.seed((P.X + Offset.X) | (P.Y + Offset.Y));
-        if (Uni(RndGen) < IntChance) {
+        if (static_cast<int>(randomBounded(RndGen, 1000001)) < IntChance) {
           MapTile = Tile;
         }
       },
       Rect);
 }
 
+/// Sets each tile of the rect to Tile with the given chance. Whether a tile is
+/// set only depends on the hash and its world position Offset + P, e.g. the
+/// chunks of a large map can be filled independently of each other.
+template <typename TileType, typename U, typename A>
+void fillRectCoordRandom(Map<TileType, U, A> &M, TileType Tile, float Chance,
+                         const CoordHash &Hash,
+                         std::optional<Rect2d<typename nd<U>::type>> Rect = {},
+                         Point2d<U> Offset = {0, 0}) {
+  const auto R = M.getContained(Rect);
+  if (R.empty()) {
+    return;
+  }
+  // Tiles with a hash below the threshold are set, 2^32 sets all of them
+  const Uint64 Thres =
+      Uint64(std::clamp(double(Chance), 0.0, 1.0) * 4294967296.0);
+  const auto Width = static_cast<std::size_t>(R.Size.W);
+  std::vector<std::uint32_t> Values(Width);
+  for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+    Hash.fillRow(R.Pos.X + Offset.X, PY + Offset.Y, Values.data(), Width);
+    if constexpr (Map<TileType, U, A>::HasContiguousTiles) {
+      TileType *Row = M.row(PY) + R.Pos.X;
+      for (std::size_t Idx = 0; Idx < Width; Idx++) {
+        // Select without a branch, the outcomes are unpredictable by design
+        const TileType Choices[2] = {Row[Idx], Tile};
+        Row[Idx] = Choices[Values[Idx] < Thres];
+      }
+    } else {
+      for (std::size_t Idx = 0; Idx < Width; Idx++) {
+        if (Values[Idx] < Thres) {
+          M.setTileUnchecked({R.Pos.X + U(Idx), PY}, Tile);
+        }
+      }
+    }
+  }
+}
+
 template <typename Iter, typename RE>
 Iter randomIterator(Iter Begin, Iter End, RE &RndEng) {
-  std::uniform_int_distribution<int> Uni(0, std::distance(Begin, End) - 1);
-  std::advance(Begin, Uni(RndEng));
+  const auto Size = std::distance(Begin, End);
+  std::advance(Begin, static_cast<decltype(Size)>(
+                          randomBounded(RndEng, Uint64(Size))));
   return Begin;
 }
 
@@ -111,18 +484,147 @@ float noise3d(float X, float Y, float Z, unsigned Octaves, float Persistence,
 float noise4d(float X, float Y, float Z, float W, unsigned Octaves,
               float Persistence, float Lacunarity);
 
+/// Evaluates noise2d for N points, Out[Idx] = noise2d(X[Idx], Y[Idx], ...).
+/// Eight points are evaluated at once with AVX2 if the CPU supports it, the
+/// results are bit identical to noise2d as long as the compiler does not
+/// contract multiplications and additions (e.g. into FMA instructions).
+void noise2dBatch(const float *X, const float *Y, float *Out, std::size_t N,
+                  unsigned Octaves, float Persistence, float Lacunarity);
+
+/// Evaluates noise3d for N points, see noise2dBatch
+void noise3dBatch(const float *X, const float *Y, const float *Z, float *Out,
+                  std::size_t N, unsigned Octaves, float Persistence,
+                  float Lacunarity);
+
+/// Simplex noise with its own permutation table, shuffled with the seed. Each
+/// seed gives uncorrelated noise for the cost of the unseeded noise of the
+/// same dimension, e.g. seeded height maps only need the 2D noise. The table
+/// is built once per instance, keep the instance around while sampling.
+class SeededNoise {
+public:
+  explicit SeededNoise(Uint64 Seed);
+
+  Uint64 getSeed() const { return Seed; }
+
+  float noise2d(float X, float Y, unsigned Octaves = 1,
+                float Persistence = 0.5f, float Lacunarity = 2.0f) const;
+
+  float noise3d(float X, float Y, float Z, unsigned Octaves = 1,
+                float Persistence = 0.5f, float Lacunarity = 2.0f) const;
+
+  /// Evaluates noise2d for N points, see Simplex::noise2dBatch
+  void noise2dBatch(const float *X, const float *Y, float *Out, std::size_t N,
+                    unsigned Octaves = 1, float Persistence = 0.5f,
+                    float Lacunarity = 2.0f) const;
+
+  /// Evaluates noise3d for N points, see Simplex::noise3dBatch
+  void noise3dBatch(const float *X, const float *Y, const float *Z,
+                    float *Out, std::size_t N, unsigned Octaves = 1,
+                    float Persistence = 0.5f, float Lacunarity = 2.0f) const;
+
+private:
+  Uint64 Seed;
+  /// Permutation of 0..255 repeated twice, sums of an index and an entry
+  /// stay within the table
+  std::array<unsigned char, 512> Perm;
+  /// 32 bit copies of the permutation and of the gradient indices Perm % 12
+  /// for the vectorized noise
+  std::array<std::int32_t, 512> Perm32;
+  std::array<std::int32_t, 512> GradIdx;
+};
+
+/// Fills the viewed tiles with noise3d, Offset is the world position of the
+/// view's top-left tile. The view may be a chunk of a larger map, e.g. to fill
+/// a large map chunk by chunk or to stream chunks into a map that is reused.
+template <typename TileCord>
+void fillNoise(MapView<float, TileCord> View, Point2d<TileCord> Offset = {0, 0},
+               int Seed = 0, float Scale = 1.0f, int Octaves = 1,
+               float Persistence = 0.5f, float Lacunarity = 2.0f) {
+  if (View.empty()) {
+    return;
+  }
+  const auto Size = View.getSize();
+  const auto Width = static_cast<std::size_t>(Size.W);
+  std::vector<float> Xs(Width), Ys(Width), Zs(Width, float(Seed));
+  for (TileCord PX = 0; PX < Size.W; PX++) {
+    Xs[PX] = float(PX + Offset.X) / Scale;
+  }
+  // Evaluate row by row, all tiles of a row share the Y coordinate
+  for (TileCord PY = 0; PY < Size.H; PY++) {
+    std::fill(Ys.begin(), Ys.end(), float(PY + Offset.Y) / Scale);
+    noise3dBatch(Xs.data(), Ys.data(), Zs.data(), View.row(PY), Width,
+                 Octaves, Persistence, Lacunarity);
+  }
+}
+
+/// Parallel fillNoise, the view is split into row bands that run on the
+/// executor
+template <typename Executor, typename TileCord,
+          typename = std::enable_if_t<IsExecutorV<Executor>>>
+void fillNoise(Executor &Exec, MapView<float, TileCord> View,
+               Point2d<TileCord> Offset = {0, 0}, int Seed = 0,
+               float Scale = 1.0f, int Octaves = 1, float Persistence = 0.5f,
+               float Lacunarity = 2.0f) {
+  forEachRowBand(Exec, View.rect(), [&](std::size_t, Rect2d<TileCord> Band) {
+    fillNoise(View.subview(Band), Offset + Band.Pos, Seed, Scale, Octaves,
+              Persistence, Lacunarity);
+  });
+}
+
+/// Fills the viewed tiles with the 2D noise of Noise, see fillNoise
+template <typename TileCord>
+void fillNoise(const SeededNoise &Noise, MapView<float, TileCord> View,
+               Point2d<TileCord> Offset = {0, 0}, float Scale = 1.0f,
+               int Octaves = 1, float Persistence = 0.5f,
+               float Lacunarity = 2.0f) {
+  if (View.empty()) {
+    return;
+  }
+  const auto Size = View.getSize();
+  const auto Width = static_cast<std::size_t>(Size.W);
+  std::vector<float> Xs(Width), Ys(Width);
+  for (TileCord PX = 0; PX < Size.W; PX++) {
+    Xs[PX] = float(PX + Offset.X) / Scale;
+  }
+  for (TileCord PY = 0; PY < Size.H; PY++) {
+    std::fill(Ys.begin(), Ys.end(), float(PY + Offset.Y) / Scale);
+    Noise.noise2dBatch(Xs.data(), Ys.data(), View.row(PY), Width, Octaves,
+                       Persistence, Lacunarity);
+  }
+}
+
+template <typename Executor, typename TileCord,
+          typename = std::enable_if_t<IsExecutorV<Executor>>>
+void fillNoise(Executor &Exec, const SeededNoise &Noise,
+               MapView<float, TileCord> View, Point2d<TileCord> Offset = {0, 0},
+               float Scale = 1.0f, int Octaves = 1, float Persistence = 0.5f,
+               float Lacunarity = 2.0f) {
+  forEachRowBand(Exec, View.rect(), [&](std::size_t, Rect2d<TileCord> Band) {
+    fillNoise(Noise, View.subview(Band), Offset + Band.Pos, Scale, Octaves,
+              Persistence, Lacunarity);
+  });
+}
+
 template <typename TileCord>
 Map<float, TileCord>
 generateNoiseMap(Size2d<TileCord> Size, Point2d<TileCord> Offset = {0, 0},
                  int Seed = 0, float Scale = 1.0f, int Octaves = 1,
                  float Persistence = 0.5f, float Lacunarity = 2.0f) {
   Map<float, TileCord> M(Size);
-  M.forEach([Seed, Scale, Offset, Octaves, Persistence, Lacunarity](auto Pos,
-                                                                    auto &T) {
-    auto GblPos = Pos + Offset;
-    T = noise3d(float(GblPos.X) / Scale, float(GblPos.Y) / Scale, Seed, Octaves,
-                Persistence, Lacunarity);
-  });
+  fillNoise(M.view(), Offset, Seed, Scale, Octaves, Persistence, Lacunarity);
+  return M;
+}
+
+template <typename TileCord, typename Executor,
+          typename = std::enable_if_t<IsExecutorV<Executor>>>
+Map<float, TileCord>
+generateNoiseMap(Executor &Exec, Size2d<TileCord> Size,
+                 Point2d<TileCord> Offset = {0, 0}, int Seed = 0,
+                 float Scale = 1.0f, int Octaves = 1, float Persistence = 0.5f,
+                 float Lacunarity = 2.0f) {
+  Map<float, TileCord> M(Size);
+  fillNoise(Exec, M.view(), Offset, Seed, Scale, Octaves, Persistence,
+            Lacunarity);
   return M;
 }
 
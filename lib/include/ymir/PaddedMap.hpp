@@ -0,0 +1,259 @@
+#ifndef YMIR_PADDED_MAP_HPP
+#define YMIR_PADDED_MAP_HPP
+
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <ymir/Map.hpp>
+#include <ymir/Types.hpp>
+
+namespace ymir {
+
+/// Map that keeps a border of Halo sentinel tiles around its interior. All
+/// positions are interior positions, i.e. {0, 0} is the top-left interior tile
+/// and the halo starts at {-Halo, -Halo}. Since every interior tile is
+/// surrounded by at least Halo tiles, neighbor queries for interior positions
+/// do not need any bounds handling, tiles outside of the interior read as the
+/// sentinel tile.
+template <typename T, typename U = int, U Halo = 1> class PaddedMap {
+  static_assert(Halo >= 1, "PaddedMap requires a halo of at least one tile");
+
+public:
+  using TileType = T;
+  using TileCord = U;
+  using TilePos = Point2d<TileCord>;
+  using MapType = Map<TileType, TileCord>;
+
+  using reference = typename MapType::reference;
+  using const_reference = typename MapType::const_reference;
+
+  static constexpr TileCord HaloSize = Halo;
+
+public:
+  PaddedMap() = default;
+
+  explicit PaddedMap(Size2d<TileCord> Size, TileType Sentinel = TileType())
+      : Size(Size), Sentinel(Sentinel), Padded(getPaddedSize(Size)) {
+    Padded.fill(Sentinel);
+  }
+
+  PaddedMap(TileCord Width, TileCord Height, TileType Sentinel = TileType())
+      : PaddedMap(Size2d<TileCord>{Width, Height}, Sentinel) {}
+
+  /// Creates padded map with the tiles of M as interior
+  explicit PaddedMap(const MapType &M, TileType Sentinel = TileType())
+      : PaddedMap(M.getSize(), Sentinel) {
+    Padded.merge(M, Offset);
+  }
+
+  Size2d<TileCord> getSize() const { return Size; }
+
+  bool empty() const { return rect().empty(); }
+
+  TileType getSentinel() const { return Sentinel; }
+
+  /// Replaces the sentinel tile in the entire halo
+  void setSentinel(TileType Tile) {
+    Sentinel = Tile;
+    const auto Interior = Rect2d<TileCord>{Offset, Size};
+    Padded.forEach([this, &Interior](TilePos P, auto &PaddedTile) {
+      if (!Interior.contains(P)) {
+        PaddedTile = Sentinel;
+      }
+    });
+  }
+
+  inline constexpr Rect2d<TileCord> rect() const {
+    return Rect2d<TileCord>{{0, 0}, Size};
+  }
+
+  /// Returns the rectangle including the halo in interior positions
+  inline constexpr Rect2d<TileCord> paddedRect() const {
+    return Rect2d<TileCord>{TilePos{0, 0} - Offset, Padded.getSize()};
+  }
+
+  /// Returns true if P is inside the interior of the map
+  inline constexpr bool contains(TilePos P) const { return rect().contains(P); }
+
+  Rect2d<TileCord>
+  getContained(std::optional<Rect2d<TileCord>> Rect = {}) const {
+    if (Rect) {
+      return rect() & *Rect;
+    }
+    return rect();
+  }
+
+  /// Returns the linear index of the interior position P into the padded data
+  inline std::size_t index(TilePos P) const { return Padded.index(P + Offset); }
+
+  inline reference getTile(TilePos P) {
+    if (!contains(P)) {
+      throw std::out_of_range("Position outside of padded map interior");
+    }
+    return Padded.getTileUnchecked(P + Offset);
+  }
+
+  inline const_reference getTile(TilePos P) const {
+    if (!contains(P)) {
+      throw std::out_of_range("Position outside of padded map interior");
+    }
+    return Padded.getTileUnchecked(P + Offset);
+  }
+
+  /// Unchecked access to the tile at P, P may be located in the halo. Only
+  /// debug builds assert that P is within the padded rect.
+  inline reference getTileUnchecked(TilePos P) {
+    return Padded.getTileUnchecked(P + Offset);
+  }
+
+  inline const_reference getTileUnchecked(TilePos P) const {
+    return Padded.getTileUnchecked(P + Offset);
+  }
+
+  inline void setTile(TilePos P, TileType Tile) { getTile(P) = Tile; }
+
+  /// Sets the tile at P without bounds checking, P may be located in the halo
+  /// like for getTileUnchecked. A halo tile keeps its value until the next
+  /// setSentinel.
+  inline void setTileUnchecked(TilePos P, TileType Tile) {
+    getTileUnchecked(P) = Tile;
+  }
+
+  /// Returns true if the tile at P is Tile, P may be located in the halo
+  inline bool isTile(TilePos P, TileType Tile) const {
+    return getTileUnchecked(P) == Tile;
+  }
+
+  /// Iterates over all neighbors of the interior position P including the ones
+  /// in the halo, calls binary function for each position and tile.
+  template <typename BinaryFunction,
+            typename DirectionProvider = EightTileDirections<TileCord>>
+  void checkNeighbors(
+      TilePos P, BinaryFunction Func,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) const {
+    assert(contains(P) && "Position outside of padded map interior");
+    DirectionProvider::forEachUnchecked(*this, P, Func);
+  }
+
+  template <typename DirectionProvider = EightTileDirections<TileCord>>
+  std::size_t getNeighborCount(
+      TilePos P, TileType Tile,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) const {
+    assert(contains(P) && "Position outside of padded map interior");
+    std::size_t Count = 0;
+    for (const auto &Dir : DirectionProvider::get()) {
+      Count += getTileUnchecked(P + Dir) == Tile;
+    }
+    return Count;
+  }
+
+  template <typename DirectionProvider = EightTileDirections<TileCord>>
+  std::size_t getNotNeighborCount(
+      TilePos P, TileType Tile,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) const {
+    return DirectionProvider::Directions.size() -
+           getNeighborCount(P, Tile, DirProv);
+  }
+
+  template <typename UnaryFunction>
+  void forEachElem(UnaryFunction Func,
+                   std::optional<Rect2d<TileCord>> Rect = {}) const {
+    auto R = getContained(Rect);
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      auto Idx = index({R.Pos.X, PY});
+      const auto End = Idx + R.Size.W;
+      for (; Idx < End; Idx++) {
+        Func(Padded[Idx]);
+      }
+    }
+  }
+
+  template <typename UnaryFunction>
+  void forEachElem(UnaryFunction Func,
+                   std::optional<Rect2d<TileCord>> Rect = {}) {
+    auto R = getContained(Rect);
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      auto Idx = index({R.Pos.X, PY});
+      const auto End = Idx + R.Size.W;
+      for (; Idx < End; Idx++) {
+        Func(Padded[Idx]);
+      }
+    }
+  }
+
+  template <typename BinaryFunction>
+  void forEach(BinaryFunction Func,
+               std::optional<Rect2d<TileCord>> Rect = {}) const {
+    auto R = getContained(Rect);
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      auto Idx = index({R.Pos.X, PY});
+      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W; PX++, Idx++) {
+        Func(TilePos{PX, PY}, Padded[Idx]);
+      }
+    }
+  }
+
+  template <typename BinaryFunction>
+  void forEach(BinaryFunction Func, std::optional<Rect2d<TileCord>> Rect = {}) {
+    auto R = getContained(Rect);
+    for (auto PY = R.Pos.Y; PY < R.Pos.Y + R.Size.H; PY++) {
+      auto Idx = index({R.Pos.X, PY});
+      for (auto PX = R.Pos.X; PX < R.Pos.X + R.Size.W; PX++, Idx++) {
+        Func(TilePos{PX, PY}, Padded[Idx]);
+      }
+    }
+  }
+
+  /// Fills the interior of the map, the halo is left untouched
+  void fill(TileType Tile) { fillRect(Tile); }
+
+  void fillRect(TileType Tile, std::optional<Rect2d<TileCord>> Rect = {}) {
+    forEachElem([&Tile](TileType &TL) { TL = Tile; }, Rect);
+  }
+
+  /// Returns the underlying map including the halo
+  const MapType &getPaddedMap() const { return Padded; }
+
+  /// Returns copy of the interior as map
+  MapType toMap() const {
+    MapType M(Size);
+    M.merge(Padded, TilePos{0, 0} - Offset);
+    return M;
+  }
+
+private:
+  static Size2d<TileCord> getPaddedSize(Size2d<TileCord> Size) {
+    return {Size.W + 2 * Halo, Size.H + 2 * Halo};
+  }
+
+  static constexpr TilePos Offset = {Halo, Halo};
+
+private:
+  Size2d<TileCord> Size;
+  TileType Sentinel = TileType();
+  MapType Padded;
+};
+
+template <typename T, typename U, U Halo>
+std::ostream &operator<<(std::ostream &Out, const PaddedMap<T, U, Halo> &M) {
+  return Out << M.toMap();
+}
+
+/// Compares the interiors of the maps, like operator<< the halo and the
+/// sentinel are ignored
+template <typename T, typename U, U Halo>
+inline bool operator==(const PaddedMap<T, U, Halo> &Lhs,
+                       const PaddedMap<T, U, Halo> &Rhs) {
+  if (Lhs.getSize() != Rhs.getSize()) {
+    return false;
+  }
+  bool Equal = true;
+  Lhs.forEach([&Rhs, &Equal](Point2d<U> P, const T &Tile) {
+    Equal = Equal && Tile == Rhs.getTileUnchecked(P);
+  });
+  return Equal;
+}
+
+} // namespace ymir
+
+#endif // #ifndef YMIR_PADDED_MAP_HPP
@@ -0,0 +1,142 @@
+#ifndef YMIR_SUMMED_AREA_TABLE_HPP
+#define YMIR_SUMMED_AREA_TABLE_HPP
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include <ymir/Map.hpp>
+#include <ymir/Types.hpp>
+
+namespace ymir {
+
+/// Summed area table (integral image) of a predicate over all tiles of a map.
+/// After a single pass over the map the number of matching tiles within any
+/// rectangle is available in O(1), which in turn gives 4-, 8- and arbitrary
+/// radius neighbor counts per tile in O(1). Tiles outside of the map never
+/// match, so the neighbor counts are identical to Map::getNeighborCount.
+template <typename U = int> class SummedAreaTable {
+public:
+  using TileCord = U;
+  using TilePos = Point2d<TileCord>;
+  using SumType = std::uint32_t;
+
+public:
+  SummedAreaTable() = default;
+
+  /// Builds the table for all tiles of M for which Pred(Tile) is true
+  template <typename MapType, typename UnaryPred>
+  SummedAreaTable(const MapType &M, UnaryPred Pred) : Size(M.getSize()) {
+    const auto Stride = static_cast<std::size_t>(Size.W) + 1;
+    Sums.assign(Stride * (static_cast<std::size_t>(Size.H) + 1), 0);
+    for (TileCord PY = 0; PY < Size.H; PY++) {
+      SumType RowSum = 0;
+      const SumType *Above = &Sums[static_cast<std::size_t>(PY) * Stride];
+      SumType *Current = &Sums[static_cast<std::size_t>(PY + 1) * Stride];
+      for (TileCord PX = 0; PX < Size.W; PX++) {
+        RowSum += Pred(M.getTileUnchecked({PX, PY})) ? 1 : 0;
+        Current[PX + 1] = Above[PX + 1] + RowSum;
+      }
+    }
+  }
+
+  /// Returns summed area table of all tiles equal to Tile
+  template <typename MapType>
+  static SummedAreaTable
+  fromTile(const MapType &M, const typename MapType::TileType &Tile) {
+    using TileType = typename MapType::TileType;
+    return SummedAreaTable(
+        M, [&Tile](const TileType &Other) { return Other == Tile; });
+  }
+
+  Size2d<TileCord> getSize() const { return Size; }
+
+  /// Returns the number of matching tiles within Rect, the rect is clipped to
+  /// the map
+  inline std::size_t count(Rect2d<TileCord> Rect) const {
+    const auto R = Rect2d<TileCord>{{0, 0}, Size} & Rect;
+    if (R.empty()) {
+      return 0;
+    }
+    return sumUnchecked(R.Pos.X, R.Pos.Y, R.Pos.X + R.Size.W,
+                        R.Pos.Y + R.Size.H);
+  }
+
+  /// Returns true if the tile at P matches, false for positions outside
+  inline bool isSet(TilePos P) const {
+    return count(Rect2d<TileCord>{P, {1, 1}}) != 0;
+  }
+
+  /// Returns the number of matching tiles in the square window of the given
+  /// radius around P, excluding P itself
+  inline std::size_t getWindowCount(TilePos P, TileCord Radius) const {
+    const auto Side = 2 * Radius + 1;
+    return count({{P.X - Radius, P.Y - Radius}, {Side, Side}}) - isSet(P);
+  }
+
+  /// Returns the number of matching neighbors of P, equal to
+  /// Map::getNeighborCount(P, Tile, DirProv) for the table's tile
+  template <typename DirectionProvider = EightTileDirections<TileCord>>
+  std::size_t getNeighborCount(
+      TilePos P,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) const {
+    if constexpr (std::is_same_v<DirectionProvider,
+                                 EightTileDirections<TileCord>>) {
+      return getWindowCount(P, 1);
+    } else if constexpr (std::is_same_v<DirectionProvider,
+                                        FourTileDirections<TileCord>>) {
+      // Horizontal and vertical line through P, both containing P
+      return count({{P.X - 1, P.Y}, {3, 1}}) +
+             count({{P.X, P.Y - 1}, {1, 3}}) - 2 * isSet(P);
+    } else {
+      std::size_t Count = 0;
+      for (const auto &Dir : DirectionProvider::get()) {
+        Count += isSet(P + Dir);
+      }
+      return Count;
+    }
+  }
+
+  /// Returns the number of neighbors of P that do not match, positions outside
+  /// of the map count as not matching
+  template <typename DirectionProvider = EightTileDirections<TileCord>>
+  std::size_t getNotNeighborCount(
+      TilePos P, DirectionProvider DirProv = DirectionProvider()) const {
+    return DirectionProvider::Directions.size() -
+           getNeighborCount(P, DirProv);
+  }
+
+private:
+  inline std::size_t sumUnchecked(TileCord X0, TileCord Y0, TileCord X1,
+                                  TileCord Y1) const {
+    const auto Stride = static_cast<std::size_t>(Size.W) + 1;
+    const auto Y0Idx = static_cast<std::size_t>(Y0) * Stride;
+    const auto Y1Idx = static_cast<std::size_t>(Y1) * Stride;
+    return Sums[Y1Idx + X1] - Sums[Y0Idx + X1] - Sums[Y1Idx + X0] +
+           Sums[Y0Idx + X0];
+  }
+
+private:
+  Size2d<TileCord> Size;
+  std::vector<SumType> Sums;
+};
+
+/// Returns map with the number of neighbors of each tile that are equal to
+/// Tile, computed in O(1) per tile
+template <typename DirectionProvider = void, typename MapType,
+          typename U = typename MapType::TileCord>
+Map<int, U> getNeighborCountMap(const MapType &M,
+                                const typename MapType::TileType &Tile) {
+  using DirProvType =
+      std::conditional_t<std::is_void_v<DirectionProvider>,
+                         EightTileDirections<U>, DirectionProvider>;
+  const auto SAT = SummedAreaTable<U>::fromTile(M, Tile);
+  Map<int, U> Counts(M.getSize());
+  Counts.forEach([&SAT](Point2d<U> P, int &Count) {
+    Count = static_cast<int>(SAT.getNeighborCount(P, DirProvType()));
+  });
+  return Counts;
+}
+
+} // namespace ymir
+
+#endif // #ifndef YMIR_SUMMED_AREA_TABLE_HPP
@@ -0,0 +1,360 @@
+#ifndef YMIR_TILED_MAP_HPP
+#define YMIR_TILED_MAP_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include <ymir/Map.hpp>
+#include <ymir/Types.hpp>
+
+namespace ymir {
+
+/// Storage layout that splits the map into BlockSize x BlockSize blocks, the
+/// blocks are stored row-major and so are the tiles within each block. Blocks
+/// at the right and bottom border are padded to the full block size.
+template <unsigned BlockSize = 16> class BlockLayout {
+  static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0,
+                "BlockSize needs to be a power of two");
+
+public:
+  static constexpr std::size_t BlockTiles = BlockSize * BlockSize;
+
+public:
+  template <typename U> void resize(Size2d<U> Size) {
+    BlocksX = (static_cast<std::size_t>(Size.W) + BlockSize - 1) / BlockSize;
+    BlocksY = (static_cast<std::size_t>(Size.H) + BlockSize - 1) / BlockSize;
+  }
+
+  /// Returns the number of tiles that need to be allocated
+  std::size_t size() const { return BlocksX * BlocksY * BlockTiles; }
+
+  template <typename U> inline std::size_t index(Point2d<U> P) const {
+    const auto X = static_cast<std::size_t>(P.X);
+    const auto Y = static_cast<std::size_t>(P.Y);
+    return ((Y / BlockSize) * BlocksX + X / BlockSize) * BlockTiles +
+           (Y % BlockSize) * BlockSize + X % BlockSize;
+  }
+
+  /// Calls Func(Pos, Index) for all positions in the rect in storage order
+  template <typename U, typename BinaryFunction>
+  void forEach(Rect2d<U> R, BinaryFunction Func) const {
+    if (R.empty()) {
+      return;
+    }
+    const U B = BlockSize;
+    const U EndX = R.Pos.X + R.Size.W, EndY = R.Pos.Y + R.Size.H;
+    for (U BY = R.Pos.Y / B * B; BY < EndY; BY += B) {
+      for (U BX = R.Pos.X / B * B; BX < EndX; BX += B) {
+        const U X0 = std::max(BX, R.Pos.X), X1 = std::min<U>(BX + B, EndX);
+        const U Y0 = std::max(BY, R.Pos.Y), Y1 = std::min<U>(BY + B, EndY);
+        for (U PY = Y0; PY < Y1; PY++) {
+          auto Idx = index(Point2d<U>{X0, PY});
+          for (U PX = X0; PX < X1; PX++, Idx++) {
+            Func(Point2d<U>{PX, PY}, Idx);
+          }
+        }
+      }
+    }
+  }
+
+private:
+  std::size_t BlocksX = 0;
+  std::size_t BlocksY = 0;
+};
+
+/// Storage layout that orders the tiles along a Z-order (Morton) curve. The
+/// storage is padded to the next power of two square, the layout is thus best
+/// suited for square maps with a power of two size.
+class MortonLayout {
+public:
+  template <typename U> void resize(Size2d<U> Size) {
+    const auto MaxSide = static_cast<std::uint64_t>(std::max(Size.W, Size.H));
+    Side = 1;
+    while (Side < MaxSide) {
+      Side <<= 1;
+    }
+    if (MaxSide == 0) {
+      Side = 0;
+    }
+  }
+
+  std::size_t size() const { return Side * Side; }
+
+  template <typename U> inline std::size_t index(Point2d<U> P) const {
+    return interleave(static_cast<std::uint32_t>(P.X)) |
+           (interleave(static_cast<std::uint32_t>(P.Y)) << 1);
+  }
+
+  template <typename U, typename BinaryFunction>
+  void forEach(Rect2d<U> R, BinaryFunction Func) const {
+    if (R.empty()) {
+      return;
+    }
+    forEachQuadrant(R, 0, 0, Side, Func);
+  }
+
+  static inline std::uint64_t interleave(std::uint32_t Value) {
+    std::uint64_t X = Value;
+    X = (X | (X << 16)) & 0x0000FFFF0000FFFFULL;
+    X = (X | (X << 8)) & 0x00FF00FF00FF00FFULL;
+    X = (X | (X << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    X = (X | (X << 2)) & 0x3333333333333333ULL;
+    X = (X | (X << 1)) & 0x5555555555555555ULL;
+    return X;
+  }
+
+  static inline std::uint32_t deinterleave(std::uint64_t X) {
+    X &= 0x5555555555555555ULL;
+    X = (X | (X >> 1)) & 0x3333333333333333ULL;
+    X = (X | (X >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    X = (X | (X >> 4)) & 0x00FF00FF00FF00FFULL;
+    X = (X | (X >> 8)) & 0x0000FFFF0000FFFFULL;
+    X = (X | (X >> 16)) & 0x00000000FFFFFFFFULL;
+    return static_cast<std::uint32_t>(X);
+  }
+
+private:
+  /// Recursively visits the quadrants overlapping the rect, quadrants that are
+  /// fully contained are a contiguous range of the storage
+  template <typename U, typename BinaryFunction>
+  void forEachQuadrant(const Rect2d<U> &R, std::uint64_t QX, std::uint64_t QY,
+                       std::uint64_t QSide, BinaryFunction &Func) const {
+    const auto Quadrant = Rect2d<U>{{static_cast<U>(QX), static_cast<U>(QY)},
+                                    {static_cast<U>(QSide),
+                                     static_cast<U>(QSide)}};
+    if (!Quadrant.overlaps(R)) {
+      return;
+    }
+    if (R.contains(Quadrant)) {
+      const auto Begin = index(Point2d<U>{Quadrant.Pos.X, Quadrant.Pos.Y});
+      const auto End = Begin + QSide * QSide;
+      for (auto Idx = Begin; Idx < End; Idx++) {
+        Func(Point2d<U>{static_cast<U>(deinterleave(Idx)),
+                        static_cast<U>(deinterleave(Idx >> 1))},
+             Idx);
+      }
+      return;
+    }
+    const auto Half = QSide / 2;
+    forEachQuadrant(R, QX, QY, Half, Func);
+    forEachQuadrant(R, QX + Half, QY, Half, Func);
+    forEachQuadrant(R, QX, QY + Half, Half, Func);
+    forEachQuadrant(R, QX + Half, QY + Half, Half, Func);
+  }
+
+private:
+  std::uint64_t Side = 0;
+};
+
+/// Map with the same interface as ymir::Map but with a configurable storage
+/// layout (see BlockLayout and MortonLayout) to improve the cache locality of
+/// neighborhood heavy algorithms. Iteration via forEach follows the storage
+/// order, in-place algorithms whose result depends on the scan order (e.g.
+/// celat::replace) thus yield different results than on a row-major map.
+template <typename T, typename U = int, typename Layout = BlockLayout<16>>
+class TiledMap {
+public:
+  using TileType = T;
+  using TileCord = U;
+  using TilePos = Point2d<TileCord>;
+  using LayoutType = Layout;
+  using DataType = std::vector<TileType>;
+
+  using reference = typename DataType::reference;
+  using const_reference = typename DataType::const_reference;
+
+public:
+  TiledMap() = default;
+
+  explicit TiledMap(Size2d<TileCord> Size) { resize(Size); }
+
+  TiledMap(TileCord Width, TileCord Height)
+      : TiledMap(Size2d<TileCord>{Width, Height}) {}
+
+  explicit TiledMap(const Map<TileType, TileCord> &M) : TiledMap(M.getSize()) {
+    M.forEach([this](TilePos P, const TileType &Tile) {
+      Data[Lay.index(P)] = Tile;
+    });
+  }
+
+  Size2d<TileCord> getSize() const { return Size; }
+
+  bool empty() const { return Data.empty(); }
+
+  void resize(Size2d<TileCord> Size) {
+    this->Size = Size;
+    Lay.resize(Size);
+    Data.resize(Lay.size());
+  }
+
+  const LayoutType &getLayout() const { return Lay; }
+
+  inline constexpr Rect2d<TileCord> rect() const {
+    return Rect2d<TileCord>{{0, 0}, Size};
+  }
+
+  inline constexpr bool contains(TilePos P) const { return rect().contains(P); }
+
+  Rect2d<TileCord>
+  getContained(std::optional<Rect2d<TileCord>> Rect = {}) const {
+    if (Rect) {
+      return rect() & *Rect;
+    }
+    return rect();
+  }
+
+  /// Returns the storage index of position P
+  inline std::size_t index(TilePos P) const { return Lay.index(P); }
+
+  inline reference getTile(TilePos P) {
+    if (!contains(P)) {
+      throw std::out_of_range("Position outside of tiled map");
+    }
+    return Data[Lay.index(P)];
+  }
+
+  inline const_reference getTile(TilePos P) const {
+    if (!contains(P)) {
+      throw std::out_of_range("Position outside of tiled map");
+    }
+    return Data[Lay.index(P)];
+  }
+
+  inline reference getTileUnchecked(TilePos P) {
+    assert(contains(P) && "Position out of map bounds");
+    return Data[Lay.index(P)];
+  }
+
+  inline const_reference getTileUnchecked(TilePos P) const {
+    assert(contains(P) && "Position out of map bounds");
+    return Data[Lay.index(P)];
+  }
+
+  inline void setTile(TilePos P, TileType Tile) { getTile(P) = Tile; }
+
+  inline void setTileUnchecked(TilePos P, TileType Tile) {
+    getTileUnchecked(P) = Tile;
+  }
+
+  inline bool isTile(TilePos P, TileType Tile) const {
+    return contains(P) && Data[Lay.index(P)] == Tile;
+  }
+
+  template <typename BinaryFunction,
+            typename DirectionProvider = EightTileDirections<TileCord>>
+  void checkNeighbors(
+      TilePos P, BinaryFunction Func,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) const {
+    DirectionProvider::forEach(*this, P, Func);
+  }
+
+  template <typename DirectionProvider = EightTileDirections<TileCord>>
+  std::size_t getNeighborCount(
+      TilePos P, TileType Tile,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) const {
+    std::size_t Count = 0;
+    for (const auto &Dir : DirectionProvider::get()) {
+      Count += isTile(P + Dir, Tile);
+    }
+    return Count;
+  }
+
+  template <typename DirectionProvider = EightTileDirections<TileCord>>
+  std::size_t getNotNeighborCount(
+      TilePos P, TileType Tile,
+      [[maybe_unused]] DirectionProvider DirProv = DirectionProvider()) const {
+    return DirectionProvider::Directions.size() -
+           getNeighborCount(P, Tile, DirProv);
+  }
+
+  template <typename UnaryFunction>
+  void forEachElem(UnaryFunction Func,
+                   std::optional<Rect2d<TileCord>> Rect = {}) const {
+    Lay.forEach(getContained(Rect),
+                [this, &Func](TilePos, std::size_t Idx) { Func(Data[Idx]); });
+  }
+
+  template <typename UnaryFunction>
+  void forEachElem(UnaryFunction Func,
+                   std::optional<Rect2d<TileCord>> Rect = {}) {
+    Lay.forEach(getContained(Rect),
+                [this, &Func](TilePos, std::size_t Idx) { Func(Data[Idx]); });
+  }
+
+  template <typename BinaryFunction>
+  void forEach(BinaryFunction Func,
+               std::optional<Rect2d<TileCord>> Rect = {}) const {
+    Lay.forEach(getContained(Rect), [this, &Func](TilePos P, std::size_t Idx) {
+      Func(P, Data[Idx]);
+    });
+  }
+
+  template <typename BinaryFunction>
+  void forEach(BinaryFunction Func, std::optional<Rect2d<TileCord>> Rect = {}) {
+    Lay.forEach(getContained(Rect), [this, &Func](TilePos P, std::size_t Idx) {
+      Func(P, Data[Idx]);
+    });
+  }
+
+  void fill(TileType Tile) { std::fill(Data.begin(), Data.end(), Tile); }
+
+  void fillRect(TileType Tile, std::optional<Rect2d<TileCord>> Rect = {}) {
+    forEachElem([&Tile](TileType &TL) { TL = Tile; }, Rect);
+  }
+
+  std::vector<TilePos> findTiles(TileType Target) const {
+    std::vector<TilePos> Result;
+    forEach([&Target, &Result](auto Pos, const auto &Tile) {
+      if (Target == Tile) {
+        Result.push_back(Pos);
+      }
+    });
+    return Result;
+  }
+
+  /// Returns row-major copy of the map
+  Map<TileType, TileCord> toMap() const {
+    Map<TileType, TileCord> M(Size);
+    forEach([&M](TilePos P, const TileType &Tile) {
+      M.setTileUnchecked(P, Tile);
+    });
+    return M;
+  }
+
+  DataType &getData() { return Data; }
+  const DataType &getData() const { return Data; }
+
+private:
+  Size2d<TileCord> Size;
+  LayoutType Lay;
+  DataType Data;
+};
+
+template <typename T, typename U, typename L>
+std::ostream &operator<<(std::ostream &Out, const TiledMap<T, U, L> &M) {
+  return Out << M.toMap();
+}
+
+/// Compares only the tiles inside the map, fill() also writes the padding
+/// tiles of partially covered blocks which setTile() never touches
+template <typename T, typename U, typename L>
+inline bool operator==(const TiledMap<T, U, L> &Lhs,
+                       const TiledMap<T, U, L> &Rhs) {
+  if (Lhs.getSize() != Rhs.getSize()) {
+    return false;
+  }
+  const auto &RhsData = Rhs.getData();
+  bool Equal = true;
+  Lhs.getLayout().forEach(Lhs.rect(), [&](auto, std::size_t Idx) {
+    Equal = Equal && Lhs.getData()[Idx] == RhsData[Idx];
+  });
+  return Equal;
+}
+
+} // namespace ymir
+
+#endif // #ifndef YMIR_TILED_MAP_HPP
@@ -386,7 +386,23 @@ template <typename TileCord, typename Derived> struct TileDirections {
       if (!Map.contains(Pos)) {
         continue;
       }
-      auto &Tile = Map.getTile(Pos);
+      auto &Tile = Map.getTileUnchecked(Pos);
+      if (!Func(Pos, Tile)) {
+        return;
+      }
+    }
+  }
+
+  /// Same as forEach but without checking whether the neighbor positions are
+  /// contained in the map, the map needs to provide a border around Start
+  /// (e.g. a PaddedMap)
+  template <typename MapType, typename BinaryFunc>
+  static inline void forEachUnchecked(MapType &Map,
+                                      ymir::Point2d<TileCord> Start,
+                                      BinaryFunc Func) {
+    for (const auto &Direction : Derived::get()) {
+      auto Pos = Start + Direction;
+      auto &Tile = Map.getTileUnchecked(Pos);
       if (!Func(Pos, Tile)) {
         return;
       }
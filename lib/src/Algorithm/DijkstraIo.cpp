@@ -1,19 +1,28 @@
+#include <algorithm>
 #include <ymir/Algorithm/DijkstraIo.hpp>
 
 namespace ymir::Algorithm {
 
+void markPath(ymir::MapView<ymir::ColoredUniChar, int> PM,
+              ymir::Point2d<int> Start, ymir::Point2d<int> End,
+              const std::vector<ymir::Point2d<int>> &Path) {
+  auto Red = ymir::RgbColor::getHeatMapColor(0, 20, 0);
+  for (const auto &Pos : Path) {
+    PM.setTile(Pos, {'*', Red});
+  }
+  PM.setTile(Start, '@');
+  PM.setTile(End, '<');
+}
+
 ymir::Map<ymir::ColoredUniChar, int>
 markPath(const ymir::Map<char, int> &Map, ymir::Point2d<int> Start,
          ymir::Point2d<int> End, const std::vector<ymir::Point2d<int>> &Path) {
+  // The tile type changes, converting is the only copy of the map
   ymir::Map<ymir::ColoredUniChar, int> PM(Map.getSize());
-  Map.forEach([&PM](auto Pos, auto Tile) {
-    PM.setTile(Pos, {Tile, ymir::NoColor{}});
+  std::transform(Map.begin(), Map.end(), PM.begin(), [](char Tile) {
+    return ymir::ColoredUniChar{Tile, ymir::NoColor{}};
   });
-
-  auto Red = ymir::RgbColor::getHeatMapColor(0, 20, 0);
-  PM.setTiles(Path, {'*', Red});
-  PM.setTile(Start, '@');
-  PM.setTile(End, '<');
+  markPath(PM.view(), Start, End, Path);
   return PM;
 }
 
@@ -0,0 +1,57 @@
+#include "CpuFeatures.hpp"
+#include <cstdint>
+#include <ymir/Noise.hpp>
+
+namespace ymir {
+
+namespace {
+
+#ifdef YMIR_AVX2
+
+/// Vectorized CoordHash::mix, lowbias32 with the same shifts and constants
+YMIR_TARGET_AVX2 inline __m256i mix(__m256i X) {
+  X = _mm256_xor_si256(X, _mm256_srli_epi32(X, 16));
+  X = _mm256_mullo_epi32(X, _mm256_set1_epi32(0x7feb352d));
+  X = _mm256_xor_si256(X, _mm256_srli_epi32(X, 15));
+  X = _mm256_mullo_epi32(X, _mm256_set1_epi32(int(0x846ca68bu)));
+  return _mm256_xor_si256(X, _mm256_srli_epi32(X, 16));
+}
+
+/// Hashes the first multiple of eight tiles of the row, returns their count
+YMIR_TARGET_AVX2 std::size_t fillRowAvx2(std::uint32_t X, std::uint32_t KeyX,
+                                         std::uint32_t RowKey,
+                                         std::uint32_t *Out, std::size_t N) {
+  const __m256i VKeyX = _mm256_set1_epi32(int(KeyX));
+  const __m256i VRowKey = _mm256_set1_epi32(int(RowKey));
+  const __m256i Step = _mm256_set1_epi32(8);
+  __m256i Xs = _mm256_add_epi32(_mm256_set1_epi32(int(X)),
+                                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+  std::size_t Idx = 0;
+  for (; Idx + 8 <= N; Idx += 8) {
+    const __m256i H = mix(_mm256_xor_si256(mix(_mm256_xor_si256(Xs, VKeyX)),
+                                           VRowKey));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(Out + Idx), H);
+    Xs = _mm256_add_epi32(Xs, Step);
+  }
+  return Idx;
+}
+
+#endif // #ifdef YMIR_AVX2
+
+} // namespace
+
+void CoordHash::fillRow(std::int64_t X, std::int64_t Y, std::uint32_t *Out,
+                        std::size_t N) const {
+  const std::uint32_t RowKey = rowKey(Y);
+  std::size_t Idx = 0;
+#ifdef YMIR_AVX2
+  if (detail::hasAvx2()) {
+    Idx = fillRowAvx2(std::uint32_t(X), KeyX, RowKey, Out, N);
+  }
+#endif
+  for (; Idx < N; Idx++) {
+    Out[Idx] = mix(mix(std::uint32_t(X + std::int64_t(Idx)) ^ KeyX) ^ RowKey);
+  }
+}
+
+} // namespace ymir
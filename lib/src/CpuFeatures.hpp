@@ -0,0 +1,28 @@
+#ifndef YMIR_CPU_FEATURES_HPP
+#define YMIR_CPU_FEATURES_HPP
+
+// Runtime dispatch of the vectorized kernels. YMIR_AVX2 is defined whenever
+// the compiler can emit AVX2 functions via YMIR_TARGET_AVX2, callers still
+// need to check hasAvx2() before calling them.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define YMIR_AVX2 1
+#define YMIR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace ymir::detail {
+
+#ifdef YMIR_AVX2
+
+/// Returns true if the executing CPU supports AVX2, the check runs only once
+inline bool hasAvx2() {
+  static const bool HasAvx2 = __builtin_cpu_supports("avx2");
+  return HasAvx2;
+}
+
+#endif // #ifdef YMIR_AVX2
+
+} // namespace ymir::detail
+
+#endif // #ifndef YMIR_CPU_FEATURES_HPP
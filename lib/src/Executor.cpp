@@ -0,0 +1,84 @@
+#include <ymir/Executor.hpp>
+
+namespace ymir {
+
+ThreadPoolExecutor::ThreadPoolExecutor(std::size_t NumWorkers) {
+  if (NumWorkers == 0) {
+    NumWorkers = std::max(1U, std::thread::hardware_concurrency());
+  }
+  Threads.reserve(NumWorkers - 1);
+  for (std::size_t Idx = 1; Idx < NumWorkers; Idx++) {
+    Threads.emplace_back([this]() { workerLoop(); });
+  }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Stop = true;
+  }
+  WorkAvailable.notify_all();
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+}
+
+void ThreadPoolExecutor::runTasks(
+    std::size_t NumTasks, const std::function<void(std::size_t)> &Func) {
+  if (NumTasks == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> RunLock(RunMutex);
+  std::unique_lock<std::mutex> Lock(Mutex);
+  Job = &Func;
+  this->NumTasks = NumTasks;
+  NextTask = 0;
+  TasksDone = 0;
+  WorkAvailable.notify_all();
+
+  processTasks(Lock);
+  WorkDone.wait(Lock, [this]() { return TasksDone == this->NumTasks; });
+  Job = nullptr;
+
+  auto TaskError = std::exchange(Error, nullptr);
+  Lock.unlock();
+  if (TaskError) {
+    std::rethrow_exception(TaskError);
+  }
+}
+
+void ThreadPoolExecutor::workerLoop() {
+  std::unique_lock<std::mutex> Lock(Mutex);
+  while (true) {
+    WorkAvailable.wait(Lock, [this]() {
+      return Stop || (Job != nullptr && NextTask < NumTasks);
+    });
+    if (Stop) {
+      return;
+    }
+    processTasks(Lock);
+  }
+}
+
+void ThreadPoolExecutor::processTasks(std::unique_lock<std::mutex> &Lock) {
+  while (Job != nullptr && NextTask < NumTasks) {
+    const auto TaskIdx = NextTask++;
+    const auto *Func = Job;
+    Lock.unlock();
+    std::exception_ptr TaskError;
+    try {
+      (*Func)(TaskIdx);
+    } catch (...) {
+      TaskError = std::current_exception();
+    }
+    Lock.lock();
+    if (TaskError && !Error) {
+      Error = TaskError;
+    }
+    if (++TasksDone == NumTasks) {
+      WorkDone.notify_all();
+    }
+  }
+}
+
+} // namespace ymir
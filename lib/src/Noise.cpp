@@ -1,43 +1,58 @@
 #include "PerlinNoise.hpp"
 #include "SimplexNoise.hpp"
+#include <numeric>
 #include <ymir/Noise.hpp>
 
 namespace ymir {
 
 namespace Simplex {
 
-float noise2d(float X, float Y, unsigned Octaves, float Persistence,
-              float Lacunarity) {
+namespace {
+
+float octaves2d(const unsigned char *Perm, float X, float Y, unsigned Octaves,
+                float Persistence, float Lacunarity) {
   float Freq = 1.0f;
   float Amp = 1.0f;
   float Max = 1.0f;
-  float Total = internal::noise2d(X, Y);
+  float Total = internal::noise2d(X, Y, Perm);
 
   for (unsigned Idx = 1; Idx < Octaves; ++Idx) {
     Freq *= Lacunarity;
     Amp *= Persistence;
     Max += Amp;
-    Total += internal::noise2d(X * Freq, Y * Freq) * Amp;
+    Total += internal::noise2d(X * Freq, Y * Freq, Perm) * Amp;
   }
   return Total / Max;
 }
 
-float noise3d(float X, float Y, float Z, unsigned Octaves, float Persistence,
-              float Lacunarity) {
+float octaves3d(const unsigned char *Perm, float X, float Y, float Z,
+                unsigned Octaves, float Persistence, float Lacunarity) {
   float Freq = 1.0f;
   float Amp = 1.0f;
   float Max = 1.0f;
-  float Total = internal::noise3d(X, Y, Z);
+  float Total = internal::noise3d(X, Y, Z, Perm);
 
   for (unsigned Idx = 1; Idx < Octaves; ++Idx) {
     Freq *= Lacunarity;
     Amp *= Persistence;
     Max += Amp;
-    Total += internal::noise3d(X * Freq, Y * Freq, Z * Freq) * Amp;
+    Total += internal::noise3d(X * Freq, Y * Freq, Z * Freq, Perm) * Amp;
   }
   return Total / Max;
 }
 
+} // namespace
+
+float noise2d(float X, float Y, unsigned Octaves, float Persistence,
+              float Lacunarity) {
+  return octaves2d(PERM, X, Y, Octaves, Persistence, Lacunarity);
+}
+
+float noise3d(float X, float Y, float Z, unsigned Octaves, float Persistence,
+              float Lacunarity) {
+  return octaves3d(PERM, X, Y, Z, Octaves, Persistence, Lacunarity);
+}
+
 float noise4d(float X, float Y, float Z, float W, unsigned Octaves,
               float Persistence, float Lacunarity) {
   float Freq = 1.0f;
@@ -54,6 +69,35 @@ float noise4d(float X, float Y, float Z, float W, unsigned Octaves,
   return Total / Max;
 }
 
+SeededNoise::SeededNoise(Uint64 Seed) : Seed(Seed) {
+  // Fisher-Yates shuffle, the bounded indices are taken from the high bits
+  // of the product to stay independent of the standard library
+  std::array<unsigned char, 256> Shuffled;
+  std::iota(Shuffled.begin(), Shuffled.end(), 0);
+  WyHashRndEng RndEng;
+  RndEng.seed(Seed);
+  for (std::size_t Idx = Shuffled.size() - 1; Idx > 0; Idx--) {
+    const auto Other =
+        static_cast<std::size_t>((Uint128(RndEng()) * (Idx + 1)) >> 64);
+    std::swap(Shuffled[Idx], Shuffled[Other]);
+  }
+  for (std::size_t Idx = 0; Idx < Perm.size(); Idx++) {
+    Perm[Idx] = Shuffled[Idx % Shuffled.size()];
+    Perm32[Idx] = Perm[Idx];
+    GradIdx[Idx] = Perm[Idx] % 12;
+  }
+}
+
+float SeededNoise::noise2d(float X, float Y, unsigned Octaves,
+                           float Persistence, float Lacunarity) const {
+  return octaves2d(Perm.data(), X, Y, Octaves, Persistence, Lacunarity);
+}
+
+float SeededNoise::noise3d(float X, float Y, float Z, unsigned Octaves,
+                           float Persistence, float Lacunarity) const {
+  return octaves3d(Perm.data(), X, Y, Z, Octaves, Persistence, Lacunarity);
+}
+
 } // namespace Simplex
 
 namespace Perlin {
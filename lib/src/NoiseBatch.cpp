@@ -0,0 +1,352 @@
+#include "CpuFeatures.hpp"
+#include "SimplexNoise.hpp"
+#include <array>
+#include <cstdint>
+#include <ymir/Noise.hpp>
+
+namespace ymir::Simplex {
+
+namespace {
+
+/// Permutation tables of the vectorized noise, widened to 32 bit for the
+/// gather instructions. GradIdx holds the gradient index Perm[Idx] % 12.
+struct GatherTables {
+  const std::int32_t *Perm;
+  const std::int32_t *GradIdx;
+};
+
+// Tables of the default permutation PERM
+struct DefaultPermTables {
+  std::array<std::int32_t, 512> Perm;
+  std::array<std::int32_t, 512> GradIdx;
+};
+
+constexpr DefaultPermTables makeDefaultPermTables() {
+  DefaultPermTables Tables{};
+  for (std::size_t Idx = 0; Idx < 512; Idx++) {
+    Tables.Perm[Idx] = PERM[Idx];
+    Tables.GradIdx[Idx] = PERM[Idx] % 12;
+  }
+  return Tables;
+}
+
+constexpr DefaultPermTables DefaultPerm = makeDefaultPermTables();
+
+#ifdef YMIR_AVX2
+
+struct GradTables {
+  std::array<float, 12> GradX, GradY, GradZ;
+};
+
+constexpr GradTables makeGradTables() {
+  GradTables Tables{};
+  for (std::size_t Idx = 0; Idx < 12; Idx++) {
+    Tables.GradX[Idx] = GRAD3[Idx][0];
+    Tables.GradY[Idx] = GRAD3[Idx][1];
+    Tables.GradZ[Idx] = GRAD3[Idx][2];
+  }
+  return Tables;
+}
+
+constexpr GradTables Grads = makeGradTables();
+
+// The vector code performs the exact operations of the scalar noise in the
+// same order, giving bit identical results. Conditions are turned into lane
+// masks, the corner offsets are 0 or 1 and subtracting a mask (-1) adds one.
+
+YMIR_TARGET_AVX2 inline __m256i perm(const GatherTables &Tab, __m256i Idx) {
+  return _mm256_i32gather_epi32(Tab.Perm, Idx, 4);
+}
+
+YMIR_TARGET_AVX2 inline __m256i gradIndex(const GatherTables &Tab,
+                                          __m256i Idx) {
+  return _mm256_i32gather_epi32(Tab.GradIdx, Idx, 4);
+}
+
+YMIR_TARGET_AVX2 inline __m256 sub(__m256 A, __m256 B) {
+  return _mm256_sub_ps(A, B);
+}
+YMIR_TARGET_AVX2 inline __m256 add(__m256 A, __m256 B) {
+  return _mm256_add_ps(A, B);
+}
+YMIR_TARGET_AVX2 inline __m256 mul(__m256 A, __m256 B) {
+  return _mm256_mul_ps(A, B);
+}
+
+/// Returns f^4 * Dot if f > 0 and 0 otherwise
+YMIR_TARGET_AVX2 inline __m256 corner(__m256 F, __m256 Dot) {
+  const __m256 N = mul(mul(mul(mul(F, F), F), F), Dot);
+  return _mm256_and_ps(N, _mm256_cmp_ps(F, _mm256_setzero_ps(), _CMP_GT_OQ));
+}
+
+YMIR_TARGET_AVX2 inline __m256 corner2d(__m256 XX, __m256 YY, __m256i G) {
+  const __m256 F = sub(sub(_mm256_set1_ps(0.5f), mul(XX, XX)), mul(YY, YY));
+  const __m256 GX = _mm256_i32gather_ps(Grads.GradX.data(), G, 4);
+  const __m256 GY = _mm256_i32gather_ps(Grads.GradY.data(), G, 4);
+  return corner(F, add(mul(GX, XX), mul(GY, YY)));
+}
+
+YMIR_TARGET_AVX2 __m256 noise2dAvx2(const GatherTables &Tab, __m256 X,
+                                    __m256 Y) {
+  const __m256 S = mul(add(X, Y), _mm256_set1_ps(F2));
+  const __m256 I = _mm256_floor_ps(add(X, S));
+  const __m256 J = _mm256_floor_ps(add(Y, S));
+  const __m256 T = mul(add(I, J), _mm256_set1_ps(G2));
+
+  const __m256 XX0 = sub(X, sub(I, T));
+  const __m256 YY0 = sub(Y, sub(J, T));
+  const __m256 I1 = _mm256_cmp_ps(XX0, YY0, _CMP_GT_OQ);
+  const __m256 J1 = _mm256_cmp_ps(XX0, YY0, _CMP_LE_OQ);
+  const __m256 One = _mm256_set1_ps(1.0f);
+
+  const __m256 XX2 = sub(add(XX0, _mm256_set1_ps(G2 * 2.0f)), One);
+  const __m256 YY2 = sub(add(YY0, _mm256_set1_ps(G2 * 2.0f)), One);
+  const __m256 XX1 =
+      add(sub(XX0, _mm256_and_ps(I1, One)), _mm256_set1_ps(G2));
+  const __m256 YY1 =
+      add(sub(YY0, _mm256_and_ps(J1, One)), _mm256_set1_ps(G2));
+
+  const __m256i Mask = _mm256_set1_epi32(255);
+  const __m256i One32 = _mm256_set1_epi32(1);
+  const __m256i II = _mm256_and_si256(_mm256_cvttps_epi32(I), Mask);
+  const __m256i JJ = _mm256_and_si256(_mm256_cvttps_epi32(J), Mask);
+  const __m256i G0 = gradIndex(Tab, _mm256_add_epi32(II, perm(Tab, JJ)));
+  const __m256i G1 = gradIndex(
+      Tab, _mm256_add_epi32(
+               _mm256_sub_epi32(II, _mm256_castps_si256(I1)),
+               perm(Tab, _mm256_sub_epi32(JJ, _mm256_castps_si256(J1)))));
+  const __m256i G2v = gradIndex(
+      Tab, _mm256_add_epi32(_mm256_add_epi32(II, One32),
+                            perm(Tab, _mm256_add_epi32(JJ, One32))));
+
+  const __m256 Sum = add(add(corner2d(XX0, YY0, G0), corner2d(XX1, YY1, G1)),
+                         corner2d(XX2, YY2, G2v));
+  return mul(Sum, _mm256_set1_ps(70.0f));
+}
+
+YMIR_TARGET_AVX2 inline __m256 corner3d(__m256 PX, __m256 PY, __m256 PZ,
+                                        __m256i G) {
+  const __m256 F = sub(sub(sub(_mm256_set1_ps(0.6f), mul(PX, PX)),
+                           mul(PY, PY)),
+                       mul(PZ, PZ));
+  const __m256 GX = _mm256_i32gather_ps(Grads.GradX.data(), G, 4);
+  const __m256 GY = _mm256_i32gather_ps(Grads.GradY.data(), G, 4);
+  const __m256 GZ = _mm256_i32gather_ps(Grads.GradZ.data(), G, 4);
+  return corner(F, add(add(mul(PX, GX), mul(PY, GY)), mul(PZ, GZ)));
+}
+
+/// Returns V + 1 in the lanes set in the mask O
+YMIR_TARGET_AVX2 inline __m256i offset(__m256i V, __m256 O) {
+  return _mm256_sub_epi32(V, _mm256_castps_si256(O));
+}
+
+/// Returns P0 - 1 + G in the lanes set in the mask O and P0 + G in the others
+YMIR_TARGET_AVX2 inline __m256 cornerPos(__m256 P0, __m256 O, float G) {
+  return add(sub(P0, _mm256_and_ps(O, _mm256_set1_ps(1.0f))),
+             _mm256_set1_ps(G));
+}
+
+/// Returns Perm[I + O1 + Perm[J + O2 + Perm[K + O3]]] % 12 for offset masks
+YMIR_TARGET_AVX2 inline __m256i gradIndex3d(const GatherTables &Tab, __m256i I,
+                                            __m256i J, __m256i K, __m256 O1,
+                                            __m256 O2, __m256 O3) {
+  const __m256i PK = perm(Tab, offset(K, O3));
+  const __m256i PJ = perm(Tab, _mm256_add_epi32(offset(J, O2), PK));
+  return gradIndex(Tab, _mm256_add_epi32(offset(I, O1), PJ));
+}
+
+YMIR_TARGET_AVX2 __m256 noise3dAvx2(const GatherTables &Tab, __m256 X,
+                                    __m256 Y, __m256 Z) {
+  const __m256 S = mul(add(add(X, Y), Z), _mm256_set1_ps(F3));
+  const __m256 I = _mm256_floor_ps(add(X, S));
+  const __m256 J = _mm256_floor_ps(add(Y, S));
+  const __m256 K = _mm256_floor_ps(add(Z, S));
+  const __m256 T = mul(add(add(I, J), K), _mm256_set1_ps(G3));
+
+  const __m256 X0 = sub(X, sub(I, T));
+  const __m256 Y0 = sub(Y, sub(J, T));
+  const __m256 Z0 = sub(Z, sub(K, T));
+
+  // Simplex corners of the scalar branches, as A = X0 >= Y0, B = Y0 >= Z0
+  // and C = X0 >= Z0
+  const __m256 A = _mm256_cmp_ps(X0, Y0, _CMP_GE_OQ);
+  const __m256 B = _mm256_cmp_ps(Y0, Z0, _CMP_GE_OQ);
+  const __m256 C = _mm256_cmp_ps(X0, Z0, _CMP_GE_OQ);
+  const __m256 Zero = _mm256_setzero_ps();
+  const __m256 All = _mm256_cmp_ps(Zero, Zero, _CMP_EQ_OQ);
+  const __m256 NotA = _mm256_andnot_ps(A, All);
+  const __m256 NotB = _mm256_andnot_ps(B, All);
+  const __m256 O1X = _mm256_and_ps(A, _mm256_or_ps(B, C));
+  const __m256 O1Y = _mm256_and_ps(NotA, B);
+  const __m256 O1Z = _mm256_andnot_ps(_mm256_and_ps(A, C), NotB);
+  const __m256 O2X = _mm256_or_ps(A, _mm256_and_ps(B, C));
+  const __m256 O2Y = _mm256_or_ps(NotA, B);
+  const __m256 O2Z = _mm256_or_ps(NotB, _mm256_andnot_ps(C, NotA));
+
+  const __m256 X1 = cornerPos(X0, O1X, G3), Y1 = cornerPos(Y0, O1Y, G3),
+               Z1 = cornerPos(Z0, O1Z, G3);
+  const __m256 X2 = cornerPos(X0, O2X, 2.0f * G3),
+               Y2 = cornerPos(Y0, O2Y, 2.0f * G3),
+               Z2 = cornerPos(Z0, O2Z, 2.0f * G3);
+  const __m256 X3 = cornerPos(X0, All, 3.0f * G3),
+               Y3 = cornerPos(Y0, All, 3.0f * G3),
+               Z3 = cornerPos(Z0, All, 3.0f * G3);
+
+  const __m256i Mask = _mm256_set1_epi32(255);
+  const __m256i II = _mm256_and_si256(_mm256_cvttps_epi32(I), Mask);
+  const __m256i JJ = _mm256_and_si256(_mm256_cvttps_epi32(J), Mask);
+  const __m256i KK = _mm256_and_si256(_mm256_cvttps_epi32(K), Mask);
+  const __m256i Gr0 = gradIndex3d(Tab, II, JJ, KK, Zero, Zero, Zero);
+  const __m256i Gr1 = gradIndex3d(Tab, II, JJ, KK, O1X, O1Y, O1Z);
+  const __m256i Gr2 = gradIndex3d(Tab, II, JJ, KK, O2X, O2Y, O2Z);
+  const __m256i Gr3 = gradIndex3d(Tab, II, JJ, KK, All, All, All);
+
+  const __m256 Sum = add(add(add(corner3d(X0, Y0, Z0, Gr0),
+                                 corner3d(X1, Y1, Z1, Gr1)),
+                             corner3d(X2, Y2, Z2, Gr2)),
+                         corner3d(X3, Y3, Z3, Gr3));
+  return mul(Sum, _mm256_set1_ps(32.0f));
+}
+
+// The octaves are summed the same way as by the scalar noise functions
+
+YMIR_TARGET_AVX2 std::size_t
+noise2dBatchAvx2(const GatherTables &Tab, const float *X, const float *Y,
+                 float *Out, std::size_t N, unsigned Octaves, float Persistence,
+                 float Lacunarity) {
+  std::size_t Idx = 0;
+  for (; Idx + 8 <= N; Idx += 8) {
+    const __m256 VX = _mm256_loadu_ps(X + Idx);
+    const __m256 VY = _mm256_loadu_ps(Y + Idx);
+    float Freq = 1.0f;
+    float Amp = 1.0f;
+    float Max = 1.0f;
+    __m256 Total = noise2dAvx2(Tab, VX, VY);
+
+    for (unsigned Oct = 1; Oct < Octaves; ++Oct) {
+      Freq *= Lacunarity;
+      Amp *= Persistence;
+      Max += Amp;
+      const __m256 F = _mm256_set1_ps(Freq);
+      Total = add(Total, mul(noise2dAvx2(Tab, mul(VX, F), mul(VY, F)),
+                             _mm256_set1_ps(Amp)));
+    }
+    _mm256_storeu_ps(Out + Idx, _mm256_div_ps(Total, _mm256_set1_ps(Max)));
+  }
+  return Idx;
+}
+
+YMIR_TARGET_AVX2 std::size_t
+noise3dBatchAvx2(const GatherTables &Tab, const float *X, const float *Y,
+                 const float *Z, float *Out, std::size_t N, unsigned Octaves,
+                 float Persistence, float Lacunarity) {
+  std::size_t Idx = 0;
+  for (; Idx + 8 <= N; Idx += 8) {
+    const __m256 VX = _mm256_loadu_ps(X + Idx);
+    const __m256 VY = _mm256_loadu_ps(Y + Idx);
+    const __m256 VZ = _mm256_loadu_ps(Z + Idx);
+    float Freq = 1.0f;
+    float Amp = 1.0f;
+    float Max = 1.0f;
+    __m256 Total = noise3dAvx2(Tab, VX, VY, VZ);
+
+    for (unsigned Oct = 1; Oct < Octaves; ++Oct) {
+      Freq *= Lacunarity;
+      Amp *= Persistence;
+      Max += Amp;
+      const __m256 F = _mm256_set1_ps(Freq);
+      const __m256 Noise = noise3dAvx2(Tab, mul(VX, F), mul(VY, F), mul(VZ, F));
+      Total = add(Total, mul(Noise, _mm256_set1_ps(Amp)));
+    }
+    _mm256_storeu_ps(Out + Idx, _mm256_div_ps(Total, _mm256_set1_ps(Max)));
+  }
+  return Idx;
+}
+
+#endif // #ifdef YMIR_AVX2
+
+/// Evaluates the vectorized noise for the points it can, the remaining ones
+/// with the scalar Noise2d(X, Y)
+template <typename ScalarFunc>
+void noise2dBatchImpl(const GatherTables &Tab, ScalarFunc Noise2d,
+                      const float *X, const float *Y, float *Out,
+                      std::size_t N, unsigned Octaves, float Persistence,
+                      float Lacunarity) {
+  std::size_t Idx = 0;
+#ifdef YMIR_AVX2
+  if (detail::hasAvx2()) {
+    Idx = noise2dBatchAvx2(Tab, X, Y, Out, N, Octaves, Persistence, Lacunarity);
+  }
+#else
+  (void)Tab, (void)Octaves, (void)Persistence, (void)Lacunarity;
+#endif
+  for (; Idx < N; Idx++) {
+    Out[Idx] = Noise2d(X[Idx], Y[Idx]);
+  }
+}
+
+template <typename ScalarFunc>
+void noise3dBatchImpl(const GatherTables &Tab, ScalarFunc Noise3d,
+                      const float *X, const float *Y, const float *Z,
+                      float *Out, std::size_t N, unsigned Octaves,
+                      float Persistence, float Lacunarity) {
+  std::size_t Idx = 0;
+#ifdef YMIR_AVX2
+  if (detail::hasAvx2()) {
+    Idx = noise3dBatchAvx2(Tab, X, Y, Z, Out, N, Octaves, Persistence,
+                           Lacunarity);
+  }
+#else
+  (void)Tab, (void)Octaves, (void)Persistence, (void)Lacunarity;
+#endif
+  for (; Idx < N; Idx++) {
+    Out[Idx] = Noise3d(X[Idx], Y[Idx], Z[Idx]);
+  }
+}
+
+} // namespace
+
+void noise2dBatch(const float *X, const float *Y, float *Out, std::size_t N,
+                  unsigned Octaves, float Persistence, float Lacunarity) {
+  noise2dBatchImpl(
+      {DefaultPerm.Perm.data(), DefaultPerm.GradIdx.data()},
+      [&](float PX, float PY) {
+        return noise2d(PX, PY, Octaves, Persistence, Lacunarity);
+      },
+      X, Y, Out, N, Octaves, Persistence, Lacunarity);
+}
+
+void noise3dBatch(const float *X, const float *Y, const float *Z, float *Out,
+                  std::size_t N, unsigned Octaves, float Persistence,
+                  float Lacunarity) {
+  noise3dBatchImpl(
+      {DefaultPerm.Perm.data(), DefaultPerm.GradIdx.data()},
+      [&](float PX, float PY, float PZ) {
+        return noise3d(PX, PY, PZ, Octaves, Persistence, Lacunarity);
+      },
+      X, Y, Z, Out, N, Octaves, Persistence, Lacunarity);
+}
+
+void SeededNoise::noise2dBatch(const float *X, const float *Y, float *Out,
+                               std::size_t N, unsigned Octaves,
+                               float Persistence, float Lacunarity) const {
+  noise2dBatchImpl(
+      {Perm32.data(), GradIdx.data()},
+      [&](float PX, float PY) {
+        return noise2d(PX, PY, Octaves, Persistence, Lacunarity);
+      },
+      X, Y, Out, N, Octaves, Persistence, Lacunarity);
+}
+
+void SeededNoise::noise3dBatch(const float *X, const float *Y, const float *Z,
+                               float *Out, std::size_t N, unsigned Octaves,
+                               float Persistence, float Lacunarity) const {
+  noise3dBatchImpl(
+      {Perm32.data(), GradIdx.data()},
+      [&](float PX, float PY, float PZ) {
+        return noise3d(PX, PY, PZ, Octaves, Persistence, Lacunarity);
+      },
+      X, Y, Z, Out, N, Octaves, Persistence, Lacunarity);
+}
+
+} // namespace ymir::Simplex
@@ -32,7 +32,7 @@ namespace ymir::Simplex::internal {
 #define F2 0.3660254037844386f  // 0.5 * (sqrt(3.0) - 1.0)
 #define G2 0.21132486540518713f // (3.0 - sqrt(3.0)) / 6.0
 
-inline float noise2d(float x, float y) {
+inline float noise2d(float x, float y, const unsigned char *Perm = PERM) {
   int i1, j1, I, J, c;
   float s = (x + y) * F2;
   float i = floorf(x + s);
@@ -56,9 +56,9 @@ inline float noise2d(float x, float y) {
 
   I = (int)i & 255;
   J = (int)j & 255;
-  g[0] = PERM[I + PERM[J]] % 12;
-  g[1] = PERM[I + i1 + PERM[J + j1]] % 12;
-  g[2] = PERM[I + 1 + PERM[J + 1]] % 12;
+  g[0] = Perm[I + Perm[J]] % 12;
+  g[1] = Perm[I + i1 + Perm[J + j1]] % 12;
+  g[2] = Perm[I + 1 + Perm[J + 1]] % 12;
 
   for (c = 0; c <= 2; c++)
     f[c] = 0.5f - xx[c] * xx[c] - yy[c] * yy[c];
@@ -81,7 +81,8 @@ inline float noise2d(float x, float y) {
 #define F3 (1.0f / 3.0f)
 #define G3 (1.0f / 6.0f)
 
-inline float noise3d(float x, float y, float z) {
+inline float noise3d(float x, float y, float z,
+                     const unsigned char *Perm = PERM) {
   int c, o1[3], o2[3], g[4], I, J, K;
   float f[4], noise[4] = {0.0f, 0.0f, 0.0f, 0.0f};
   float s = (x + y + z) * F3;
@@ -129,10 +130,10 @@ inline float noise3d(float x, float y, float z) {
   I = (int)i & 255;
   J = (int)j & 255;
   K = (int)k & 255;
-  g[0] = PERM[I + PERM[J + PERM[K]]] % 12;
-  g[1] = PERM[I + o1[0] + PERM[J + o1[1] + PERM[o1[2] + K]]] % 12;
-  g[2] = PERM[I + o2[0] + PERM[J + o2[1] + PERM[o2[2] + K]]] % 12;
-  g[3] = PERM[I + 1 + PERM[J + 1 + PERM[K + 1]]] % 12;
+  g[0] = Perm[I + Perm[J + Perm[K]]] % 12;
+  g[1] = Perm[I + o1[0] + Perm[J + o1[1] + Perm[o1[2] + K]]] % 12;
+  g[2] = Perm[I + o2[0] + Perm[J + o2[1] + Perm[o2[2] + K]]] % 12;
+  g[3] = Perm[I + 1 + Perm[J + 1 + Perm[K + 1]]] % 12;
 
   for (c = 0; c <= 3; c++) {
     f[c] = 0.6f - pos[c][0] * pos[c][0] - pos[c][1] * pos[c][1] -
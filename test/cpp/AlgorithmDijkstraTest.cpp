@@ -1,5 +1,6 @@
 #include "TestHelpers.hpp"
 #include <gtest/gtest.h>
+#include <random>
 #include <ymir/Algorithm/Dijkstra.hpp>
 
 using namespace ymir;
@@ -171,4 +172,116 @@ TEST(AlgorithmDijkstraTest, FindPathEightTile) {
   EXPECT_EQ(Map, MapRef) << "Map:\n" << Map << "\nMap Ref:\n" << MapRef;
 }
 
-} // namespace
\ No newline at end of file
+// Priority queue implementation the unit cost map has to match
+template <typename DirectionProvider, typename UnaryPred>
+ymir::Map<int, int>
+refDijkstraMap(ymir::Size2d<int> Size,
+               const std::vector<ymir::Point2d<int>> &Starts,
+               UnaryPred IsBlocked) {
+  ymir::Map<int, int> DM(Size);
+  DM.fill(-1);
+  auto Queue = ymir::Algorithm::getDijkstraQueue(Starts);
+  while (!Queue.empty()) {
+    auto [Dist, PosX, PosY] = Queue.top();
+    Queue.pop();
+    DM.setTile({PosX, PosY}, Dist);
+    DirectionProvider::forEach(DM, {PosX, PosY}, [&](auto Pos, auto &Tile) {
+      if (!IsBlocked(Pos) && Tile == -1) {
+        Tile = Dist + 1;
+        Queue.push({Dist + 1, Pos.X, Pos.Y});
+      }
+      return true;
+    });
+  }
+  return DM;
+}
+
+// Plain Dijkstra with the cost of entering a tile
+template <typename DirectionProvider, typename CostFunc>
+ymir::Map<int, int>
+refWeightedDijkstraMap(ymir::Size2d<int> Size,
+                       const std::vector<ymir::Point2d<int>> &Starts,
+                       CostFunc Cost) {
+  ymir::Map<int, int> DM(Size);
+  DM.fill(-1);
+  auto Queue = ymir::Algorithm::getDijkstraQueue(Starts);
+  while (!Queue.empty()) {
+    auto [Dist, PosX, PosY] = Queue.top();
+    Queue.pop();
+    if (DM.getTile({PosX, PosY}) != -1) {
+      continue;
+    }
+    DM.setTile({PosX, PosY}, Dist);
+    DirectionProvider::forEach(DM, {PosX, PosY}, [&](auto Pos, auto &Tile) {
+      if (Cost(Pos) >= 0 && Tile == -1) {
+        Queue.push({Dist + Cost(Pos), Pos.X, Pos.Y});
+      }
+      return true;
+    });
+  }
+  return DM;
+}
+
+TEST(AlgorithmDijkstraTest, UnitCostMatchesPriorityQueue) {
+  const auto M = makeRandomMap({71, 43}, 5, 0.7f);
+  const auto IsBlocked = [&M](auto Pos) { return M.getTile(Pos) != ' '; };
+  // Adjacent, duplicate and blocked starts given out of order
+  std::vector<ymir::Point2d<int>> Starts = {
+      {30, 20}, {3, 4}, {30, 19}, {29, 20}, {3, 4}, {60, 40}};
+  Starts.push_back(M.findTiles('#').at(0));
+  for (const auto &S : {Starts, std::vector<ymir::Point2d<int>>{{9, 9}}}) {
+    EXPECT_MAP_EQ(
+        ymir::Algorithm::getDijkstraMap(M.getSize(), S, IsBlocked),
+        refDijkstraMap<FourTileDirections>(M.getSize(), S, IsBlocked));
+    EXPECT_MAP_EQ(
+        ymir::Algorithm::getDijkstraMap(M.getSize(), S, IsBlocked,
+                                        EightTileDirections()),
+        refDijkstraMap<EightTileDirections>(M.getSize(), S, IsBlocked));
+  }
+}
+
+TEST(AlgorithmDijkstraTest, WeightedMatchesPriorityQueue) {
+  const auto M = makeRandomMap({67, 45}, 9, 0.7f);
+  std::mt19937 RndEng(13);
+  ymir::Map<int, int> Costs(M.getSize());
+  Costs.forEach([&](auto Pos, int &Cost) {
+    Cost = M.getTile(Pos) == ' ' ? int(RndEng() % 5) : -1;
+  });
+  const auto Cost = [&Costs](auto Pos) { return Costs.getTile(Pos); };
+  const std::vector<ymir::Point2d<int>> Starts = {{40, 2}, {5, 30}, {6, 30}};
+  EXPECT_MAP_EQ(
+      ymir::Algorithm::getWeightedDijkstraMap(M.getSize(), Starts, Cost, 4),
+      refWeightedDijkstraMap<FourTileDirections>(M.getSize(), Starts, Cost));
+  EXPECT_MAP_EQ(
+      ymir::Algorithm::getWeightedDijkstraMap(M.getSize(), Starts, Cost, 7,
+                                              EightTileDirections()),
+      refWeightedDijkstraMap<EightTileDirections>(M.getSize(), Starts, Cost));
+  EXPECT_THROW(
+      ymir::Algorithm::getWeightedDijkstraMap(M.getSize(), Starts, Cost, 3),
+      std::out_of_range);
+
+  // Unit costs give the unit cost map, as long as no start is next to another
+  const auto IsBlocked = [&M](auto Pos) { return M.getTile(Pos) != ' '; };
+  const auto UnitCost = [&IsBlocked](auto Pos) {
+    return IsBlocked(Pos) ? -1 : 1;
+  };
+  const std::vector<ymir::Point2d<int>> Apart = {{40, 2}, {5, 30}};
+  EXPECT_MAP_EQ(
+      ymir::Algorithm::getWeightedDijkstraMap(M.getSize(), Apart, UnitCost, 1),
+      ymir::Algorithm::getDijkstraMap(M.getSize(), Apart, IsBlocked));
+}
+
+TEST(AlgorithmDijkstraTest, StartOutsideOfMap) {
+  const auto IsBlocked = [](auto) { return false; };
+  const auto UnitCost = [](auto) { return 1; };
+  for (const auto &Start : {ymir::Point2d<int>{10, 10}, {5, 0}, {-1, 2}}) {
+    const std::vector<ymir::Point2d<int>> Starts = {{1, 1}, Start};
+    EXPECT_THROW(ymir::Algorithm::getDijkstraMap({4, 4}, Starts, IsBlocked),
+                 std::out_of_range);
+    EXPECT_THROW(
+        ymir::Algorithm::getWeightedDijkstraMap({4, 4}, Starts, UnitCost, 1),
+        std::out_of_range);
+  }
+}
+
+} // namespace
@@ -0,0 +1,134 @@
+#include "TestHelpers.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <ymir/BitMap.hpp>
+#include <ymir/Map.hpp>
+#include <ymir/MapIo.hpp>
+
+namespace {
+
+using BitMap = ymir::BitMap<int>;
+
+ymir::Map<char, int> getRandomMap(ymir::Size2d<int> Size, unsigned Seed) {
+  ymir::Map<char, int> M(Size);
+  std::mt19937 RndEng(Seed);
+  M.forEachElem([&RndEng](char &Tile) { Tile = RndEng() % 2 ? '#' : ' '; });
+  return M;
+}
+
+TEST(BitMapTest, SetGetTile) {
+  BitMap BM(130, 3);
+  EXPECT_EQ(BM.getWordsPerRow(), 3);
+  EXPECT_EQ(BM.count(), 0);
+  BM.setTile({0, 0}, true);
+  BM.setTile({64, 1}, true);
+  BM.setTile({129, 2}, true);
+  EXPECT_TRUE(BM.getTile({0, 0}));
+  EXPECT_TRUE(BM.getTile({64, 1}));
+  EXPECT_TRUE(BM.getTile({129, 2}));
+  EXPECT_FALSE(BM.getTile({63, 1}));
+  EXPECT_FALSE(BM.isTile({130, 2}, true));
+  EXPECT_THROW(BM.getTile({130, 2}), std::out_of_range);
+  EXPECT_EQ(BM.count(), 3);
+  EXPECT_EQ(BM.findTiles(), (std::vector<ymir::Point2d<int>>{
+                                {0, 0}, {64, 1}, {129, 2}}));
+
+  BM.setTile({64, 1}, false);
+  EXPECT_EQ(BM.count(), 2);
+
+  BM.fill(true);
+  EXPECT_EQ(BM.count(), 130 * 3);
+  BM.fillRect(false, ymir::Rect2d<int>{{60, 1}, {70, 1}});
+  EXPECT_EQ(BM.count(), 130 * 3 - 70);
+  EXPECT_TRUE(BM.getTile({59, 1}));
+  EXPECT_FALSE(BM.getTile({60, 1}));
+  EXPECT_FALSE(BM.getTile({129, 1}));
+}
+
+TEST(BitMapTest, MapConversion) {
+  auto Map = ymir::loadMap({
+      "# #",
+      "#x#",
+      "###",
+  });
+  auto BM = BitMap::fromMap(Map, '#');
+  EXPECT_EQ(BM.getSize(), Map.getSize());
+  EXPECT_EQ(BM.count(), 7);
+  EXPECT_MAP_EQ(BM.toMap('#', ' '), ymir::loadMap({
+                                        "# #",
+                                        "# #",
+                                        "###",
+                                    }));
+
+  auto BMPred = BitMap::fromMap(Map, [](char Tile) { return Tile != '#'; });
+  EXPECT_EQ(BMPred, ~BM);
+
+  // Bool maps have no addressable tiles, they are converted tile by tile
+  const auto BoolMap = BM.toMap<bool>(true, false);
+  EXPECT_EQ(BoolMap.findTiles(true).size(), 7u);
+  EXPECT_FALSE(BoolMap.getTile({1, 1}));
+  EXPECT_EQ(BitMap::fromMap(BoolMap, true), BM);
+  EXPECT_EQ(BitMap::fromMap(BoolMap, [](bool Tile) { return !Tile; }), ~BM);
+}
+
+TEST(BitMapTest, ForEach) {
+  auto Map = getRandomMap({100, 7}, 1);
+  auto BM = BitMap::fromMap(Map, '#');
+  BM.forEach([&Map](auto Pos, bool Tile) {
+    EXPECT_EQ(Tile, Map.getTile(Pos) == '#') << Pos;
+  });
+
+  BM.forEach([](auto, bool &Tile) { Tile = !Tile; },
+             ymir::Rect2d<int>{{10, 2}, {80, 3}});
+  Map.forEach([&BM](auto Pos, char Tile) {
+    bool Flipped = ymir::Rect2d<int>{{10, 2}, {80, 3}}.contains(Pos);
+    EXPECT_EQ(BM.getTile(Pos), (Tile == '#') != Flipped) << Pos;
+  });
+}
+
+TEST(BitMapTest, WordOperations) {
+  auto MapA = getRandomMap({150, 5}, 2);
+  auto MapB = getRandomMap({150, 5}, 3);
+  auto A = BitMap::fromMap(MapA, '#');
+  auto B = BitMap::fromMap(MapB, '#');
+  auto And = A & B;
+  auto Or = A | B;
+  auto Xor = A ^ B;
+  auto Not = ~A;
+  std::size_t CountA = 0;
+  MapA.forEach([&](auto Pos, char Tile) {
+    bool TA = Tile == '#', TB = MapB.getTile(Pos) == '#';
+    CountA += TA;
+    EXPECT_EQ(And.getTile(Pos), TA && TB);
+    EXPECT_EQ(Or.getTile(Pos), TA || TB);
+    EXPECT_EQ(Xor.getTile(Pos), TA != TB);
+    EXPECT_EQ(Not.getTile(Pos), !TA);
+  });
+  EXPECT_EQ(A.count(), CountA);
+  EXPECT_EQ(Not.count(), 150 * 5 - CountA);
+}
+
+TEST(BitMapTest, Shifted) {
+  auto Map = getRandomMap({150, 5}, 4);
+  auto BM = BitMap::fromMap(Map, '#');
+  for (ymir::Point2d<int> Offset :
+       {ymir::Point2d<int>{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {-1, 1}, {1, -1},
+        {65, 2}, {-64, 0}, {-70, -1}, {200, 0}}) {
+    auto Shifted = BM.shifted(Offset);
+    Map.forEach([&Shifted, &Map, Offset](auto Pos, char) {
+      auto Src = Pos + Offset;
+      bool Expected = Map.contains(Src) && Map.getTile(Src) == '#';
+      EXPECT_EQ(Shifted.getTile(Pos), Expected) << Pos << " " << Offset;
+    });
+  }
+}
+
+TEST(BitMapTest, NeighborCount) {
+  auto Map = getRandomMap({70, 4}, 5);
+  auto BM = BitMap::fromMap(Map, '#');
+  Map.forEach([&Map, &BM](auto Pos, char) {
+    EXPECT_EQ(BM.getNeighborCount(Pos, true), Map.getNeighborCount(Pos, '#'));
+  });
+}
+
+} // namespace
@@ -0,0 +1,169 @@
+#include "TestHelpers.hpp"
+#include <gtest/gtest.h>
+#include <ymir/CallularAutomata.hpp>
+#include <ymir/Executor.hpp>
+#include <ymir/Map.hpp>
+#include <ymir/MapIo.hpp>
+
+namespace {
+
+// Straight forward double-buffered reference of the threshold rules
+void refGenerate(ymir::Map<char, int> &M, char Tile, std::size_t Thres,
+                 ymir::Rect2d<int> Rect) {
+  const auto Prev = M;
+  M.forEach(
+      [&Prev, Tile, Thres](ymir::Point2d<int> P, char &MapTile) {
+        if (Prev.getNeighborCount(P, Tile) >= Thres) {
+          MapTile = Tile;
+        }
+      },
+      Rect);
+}
+
+void refReplace(ymir::Map<char, int> &M, char Target, char Replace,
+                std::size_t Thres, ymir::Rect2d<int> Rect) {
+  const auto Prev = M;
+  M.forEach(
+      [&Prev, Target, Replace, Thres](ymir::Point2d<int> P, char &MapTile) {
+        if (MapTile == Target && Prev.getNeighborCount(P, Target) < Thres) {
+          MapTile = Replace;
+        }
+      },
+      Rect);
+}
+
+TEST(CellularAutomataTest, SynchronousIgnoresScanOrder) {
+  auto M = ymir::loadMap({
+      "#####",
+      "# ###",
+      "#####",
+  });
+  // In place the update of (1,1) lets (2,1) pass the threshold as well
+  auto InPlace = M;
+  ymir::celat::generate(InPlace, ' ', 1);
+  ymir::celat::Automaton<int> CA;
+  CA.generate(M, ' ', 1);
+  EXPECT_MAP_EQ(M, ymir::loadMap({
+                       "   ##",
+                       "   ##",
+                       "   ##",
+                   }));
+  EXPECT_FALSE(M == InPlace);
+}
+
+TEST(CellularAutomataTest, SynchronousMatchesReference) {
+  const std::vector<ymir::Rect2d<int>> Rects = {
+      {{0, 0}, {61, 37}}, {{5, 3}, {20, 17}}, {{-4, 30}, {100, 100}}};
+  for (const auto &Rect : Rects) {
+    auto M = makeRandomMap({61, 37}, 3, 0.55f);
+    auto Ref = M;
+    ymir::celat::Automaton<int> CA;
+
+    CA.replace(M, ' ', '#', 4, 6, Rect);
+    for (int Idx = 0; Idx < 6; Idx++) {
+      refReplace(Ref, ' ', '#', 4, Rect);
+    }
+    EXPECT_EQ(M, Ref) << Rect;
+
+    CA.generate(M, ' ', 5, 2, Rect);
+    refGenerate(Ref, ' ', 5, Rect);
+    refGenerate(Ref, ' ', 5, Rect);
+    EXPECT_EQ(M, Ref) << Rect;
+
+    CA.generate(M, '#', 8, 1, Rect);
+    refGenerate(Ref, '#', 8, Rect);
+    EXPECT_EQ(M, Ref) << Rect;
+  }
+}
+
+TEST(CellularAutomataTest, InPlaceMatchesLegacy) {
+  auto M = makeRandomMap({48, 31}, 11, 0.55f);
+  auto Ref = M;
+  ymir::celat::Automaton<int> CA(ymir::celat::UpdateMode::InPlace);
+  CA.replace(M, ' ', '#', 4, 6);
+  CA.generate(M, ' ', 5);
+  CA.generate(M, '#', 8);
+  for (int Idx = 0; Idx < 6; Idx++) {
+    ymir::celat::replace(Ref, ' ', '#', 4);
+  }
+  ymir::celat::generate(Ref, ' ', 5);
+  ymir::celat::generate(Ref, '#', 8);
+  EXPECT_MAP_EQ(M, Ref);
+}
+
+TEST(CellularAutomataTest, UntilStableMatchesFixedIterations) {
+  const auto Start = makeRandomMap({120, 80}, 29, 0.55f);
+  const ymir::Rect2d<int> Rect{{2, 3}, {100, 70}};
+  for (const auto Mode : {ymir::celat::UpdateMode::Synchronous,
+                          ymir::celat::UpdateMode::InPlace}) {
+    ymir::celat::Automaton<int> CA(Mode);
+    for (const std::size_t MaxIterations : {0, 1, 2, 5, 100}) {
+      auto M = Start, Ref = Start;
+      const auto Replaced =
+          CA.replaceUntilStable(M, ' ', '#', 5, MaxIterations, Rect);
+      CA.replace(Ref, ' ', '#', 5, MaxIterations, Rect);
+      EXPECT_LE(Replaced, MaxIterations);
+      EXPECT_MAP_EQ(M, Ref);
+
+      // Running only the needed generations gives the same map
+      Ref = Start;
+      CA.replace(Ref, ' ', '#', 5, Replaced, Rect);
+      EXPECT_MAP_EQ(M, Ref);
+
+      const auto Generated = CA.generateUntilStable(M, ' ', 6, MaxIterations);
+      CA.generate(Ref, ' ', 6, MaxIterations);
+      EXPECT_LE(Generated, MaxIterations);
+      EXPECT_MAP_EQ(M, Ref);
+    }
+    // Caves settle long before 100 generations
+    auto M = Start;
+    EXPECT_LT(CA.replaceUntilStable(M, ' ', '#', 5, 100), 100u);
+    EXPECT_EQ(CA.replaceUntilStable(M, ' ', '#', 5, 100), 0u);
+  }
+}
+
+TEST(CellularAutomataTest, FusedMatchesSingleGenerations) {
+  // Several blocks per band, fusing up to more generations than are run
+  const auto Start = makeRandomMap({1000, 1200}, 31, 0.55f);
+  const ymir::Rect2d<int> Rect{{4, 2}, {990, 1190}};
+  ymir::ThreadPoolExecutor Pool(3);
+  ymir::celat::Automaton<int> RefCA;
+  for (const std::size_t Fused : {2, 3, 8}) {
+    ymir::celat::Automaton<int> CA(ymir::celat::UpdateMode::Synchronous,
+                                   Fused);
+    auto M = Start, Ref = Start;
+    CA.replace(M, ' ', '#', 4, 6, Rect);
+    RefCA.replace(Ref, ' ', '#', 4, 6, Rect);
+    EXPECT_MAP_EQ(M, Ref);
+    CA.generate(Pool, M, ' ', 5, 5);
+    RefCA.generate(Ref, ' ', 5, 5);
+    EXPECT_MAP_EQ(M, Ref);
+  }
+}
+
+TEST(CellularAutomataTest, ThreadPoolMatchesSequential) {
+  ymir::ThreadPoolExecutor Pool(4);
+  // Few rows give bands of a single row, all rows of a band share the halo
+  for (const ymir::Size2d<int> Size :
+       {ymir::Size2d<int>{97, 3}, ymir::Size2d<int>{53, 101}}) {
+    auto M = makeRandomMap(Size, 17, 0.55f);
+    auto Ref = M;
+    ymir::celat::Automaton<int> CA, RefCA;
+
+    // Cave generation sequence of the procedural caves example
+    CA.replace(Pool, M, ' ', '#', 4, 6);
+    CA.generate(Pool, M, ' ', 5);
+    CA.generate(Pool, M, '#', 8);
+    RefCA.replace(Ref, ' ', '#', 4, 6);
+    RefCA.generate(Ref, ' ', 5);
+    RefCA.generate(Ref, '#', 8);
+    EXPECT_MAP_EQ(M, Ref);
+
+    const ymir::Rect2d<int> Rect{{3, 1}, {40, Size.H - 1}};
+    CA.replace(Pool, M, '#', ' ', 6, 3, Rect);
+    RefCA.replace(Ref, '#', ' ', 6, 3, Rect);
+    EXPECT_MAP_EQ(M, Ref);
+  }
+}
+
+} // namespace
@@ -0,0 +1,85 @@
+#include "TestHelpers.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+#include <ymir/ChunkedMap.hpp>
+#include <ymir/Map.hpp>
+
+namespace {
+
+using ChunkedMap = ymir::ChunkedMap<int, int>;
+
+/// Fills each tile with a value derived from its world position
+void generateChunk(ChunkedMap::ChunkType &Chunk, ymir::Point2d<int> Origin) {
+  Chunk.forEach([&Origin](auto Pos, int &Tile) {
+    const auto World = Pos + Origin;
+    Tile = World.X * 1000 + World.Y;
+  });
+}
+
+TEST(ChunkedMapTest, ChunkPosition) {
+  ChunkedMap CM({4, 3}, generateChunk);
+  EXPECT_EQ(CM.getChunkPos({0, 0}), ymir::Point2d<int>(0, 0));
+  EXPECT_EQ(CM.getChunkPos({3, 2}), ymir::Point2d<int>(0, 0));
+  EXPECT_EQ(CM.getChunkPos({4, 3}), ymir::Point2d<int>(1, 1));
+  EXPECT_EQ(CM.getChunkPos({-1, -1}), ymir::Point2d<int>(-1, -1));
+  EXPECT_EQ(CM.getChunkPos({-4, -3}), ymir::Point2d<int>(-1, -1));
+  EXPECT_EQ(CM.getChunkPos({-5, -4}), ymir::Point2d<int>(-2, -2));
+  EXPECT_EQ(CM.getChunkOrigin({-2, 1}), ymir::Point2d<int>(-8, 3));
+}
+
+TEST(ChunkedMapTest, LazyGeneration) {
+  std::size_t Generated = 0;
+  ChunkedMap CM({4, 4}, [&Generated](auto &Chunk, auto Origin) {
+    Generated++;
+    generateChunk(Chunk, Origin);
+  });
+  EXPECT_EQ(CM.getLoadedChunkCount(), 0);
+  EXPECT_FALSE(CM.isLoaded({-10, 7}));
+
+  EXPECT_EQ(CM.getTile({-10, 7}), -10 * 1000 + 7);
+  EXPECT_EQ(CM.getTile({-9, 6}), -9 * 1000 + 6);
+  EXPECT_EQ(Generated, 1);
+  EXPECT_TRUE(CM.isLoaded({-10, 7}));
+
+  CM.setTile({100, -100}, 42);
+  EXPECT_EQ(CM.getTile({100, -100}), 42);
+  EXPECT_EQ(Generated, 2);
+
+  auto M = CM.copyRect({{-2, -2}, {5, 5}});
+  EXPECT_EQ(Generated, 6);
+  M.forEach([](auto Pos, int Tile) {
+    EXPECT_EQ(Tile, (Pos.X - 2) * 1000 + Pos.Y - 2) << Pos;
+  });
+  EXPECT_EQ(CM.getNeighborCount({0, 0}, 1000), 1);
+}
+
+TEST(ChunkedMapTest, LruEviction) {
+  std::vector<ymir::Point2d<int>> Evicted;
+  ChunkedMap CM({2, 2}, generateChunk, 2 * 2 * sizeof(int) * 2);
+  CM.setEvictCallback([&Evicted](const auto &Chunk, auto Origin) {
+    EXPECT_EQ(Chunk.getSize(), ymir::Size2d<int>(2, 2));
+    Evicted.push_back(Origin);
+  });
+  EXPECT_EQ(CM.getMaxChunks(), 2);
+
+  CM.setTile({0, 0}, -1);
+  CM.getTile({2, 0});
+  // Touch first chunk again, second one is now least recently used
+  EXPECT_EQ(CM.getTile({1, 1}), 1001);
+  CM.getTile({4, 0});
+  EXPECT_EQ(CM.getLoadedChunkCount(), 2);
+  EXPECT_EQ(Evicted, (std::vector<ymir::Point2d<int>>{{2, 0}}));
+  EXPECT_EQ(CM.getTile({0, 0}), -1);
+
+  CM.getTile({6, 0});
+  CM.getTile({8, 0});
+  EXPECT_EQ(Evicted,
+            (std::vector<ymir::Point2d<int>>{{2, 0}, {4, 0}, {0, 0}}));
+  // Evicted chunk is generated again, changes are lost
+  EXPECT_EQ(CM.getTile({0, 0}), 0);
+
+  CM.clear();
+  EXPECT_EQ(CM.getLoadedChunkCount(), 0);
+}
+
+} // namespace
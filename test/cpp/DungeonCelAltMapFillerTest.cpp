@@ -0,0 +1,98 @@
+#include "TestHelpers.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <ymir/Config/AnyDict.hpp>
+#include <ymir/Dungeon/BuilderPass.hpp>
+#include <ymir/Dungeon/CelAltMapFiller.hpp>
+#include <ymir/Dungeon/Context.hpp>
+#include <ymir/LayeredMap.hpp>
+#include <ymir/Noise.hpp>
+
+using namespace ymir;
+using namespace ymir::Dungeon;
+
+namespace {
+
+using Filler = CelAltMapFiller<char, int, WyHashRndEng>;
+
+ymir::Config::AnyDict getCfg() {
+  ymir::Config::AnyDict Cfg;
+  Cfg["dungeon/seed"] = 7u;
+  Cfg["celalt/layer"] = std::string("walls");
+  Cfg["celalt/tile"] = '#';
+  Cfg["celalt/clear_tile"] = ' ';
+  return Cfg;
+}
+
+Map<char, int> runFiller(ymir::Config::AnyDict Cfg) {
+  BuilderPass Pass;
+  Pass.registerBuilder<Filler>();
+  Pass.setBuilderAlias(Filler::Type, "celalt");
+  Pass.setSequence({"celalt"});
+  Pass.configure(std::move(Cfg));
+  LayeredMap<char, int> Map({"walls"}, {61, 37});
+  Context<char, int> Ctx(Map);
+  Pass.init(Ctx);
+  Pass.run(Ctx);
+  return Map.get("walls");
+}
+
+TEST(DungeonCelAltMapFillerTest, FusedIterationsImplySynchronous) {
+  auto Cfg = getCfg();
+  const auto InPlace = runFiller(Cfg);
+  Cfg["celalt/synchronous"] = true;
+  const auto Synchronous = runFiller(Cfg);
+  EXPECT_FALSE(InPlace == Synchronous);
+
+  Cfg = getCfg();
+  Cfg["celalt/fused_iterations"] = 4u;
+  EXPECT_MAP_EQ(runFiller(Cfg), Synchronous);
+}
+
+TEST(DungeonCelAltMapFillerTest, ConflictingOptionsThrow) {
+  auto Cfg = getCfg();
+  Cfg["celalt/fused_iterations"] = 4u;
+  Cfg["celalt/synchronous"] = false;
+  EXPECT_THROW(runFiller(Cfg), std::runtime_error);
+
+  // The life rule replaces the threshold rule and its update options
+  Cfg = getCfg();
+  Cfg["celalt/ca_rule"] = std::string("B5678/S45678");
+  EXPECT_NO_THROW(runFiller(Cfg));
+  Cfg["celalt/replace_thres"] = 5u;
+  EXPECT_THROW(runFiller(Cfg), std::runtime_error);
+  Cfg = getCfg();
+  Cfg["celalt/ca_rule"] = std::string("B5678/S45678");
+  Cfg["celalt/fused_iterations"] = 2u;
+  EXPECT_THROW(runFiller(Cfg), std::runtime_error);
+}
+
+TEST(DungeonCelAltMapFillerTest, PmrContext) {
+  using PmrAlloc = std::pmr::polymorphic_allocator<char>;
+  using PmrFiller = CelAltMapFiller<char, int, WyHashRndEng, PmrAlloc>;
+  auto Cfg = getCfg();
+  auto RuleCfg = Cfg;
+  RuleCfg["celalt/ca_rule"] = std::string("B5678/S45678");
+
+  for (const auto &C : {Cfg, RuleCfg}) {
+    BuilderPass Pass;
+    Pass.registerBuilder<PmrFiller>();
+    Pass.setBuilderAlias(PmrFiller::Type, "celalt");
+    Pass.setSequence({"celalt"});
+    Pass.configure(C);
+    std::pmr::monotonic_buffer_resource Arena;
+    pmr::LayeredMap<char, int> Map({"walls"}, {61, 37}, &Arena);
+    Context<char, int, PmrAlloc> Ctx(Map);
+    Pass.init(Ctx);
+    Pass.run(Ctx);
+
+    // The allocator does not change the generated cave
+    const auto Ref = runFiller(C);
+    const auto &Walls = Map.get("walls");
+    EXPECT_TRUE(std::equal(Ref.begin(), Ref.end(), Walls.begin(), Walls.end()));
+    EXPECT_EQ(Walls.get_allocator().resource(), &Arena);
+  }
+}
+
+} // namespace
@@ -0,0 +1,100 @@
+#include "TestHelpers.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <ymir/Config/AnyDict.hpp>
+#include <ymir/Dungeon/BuilderPass.hpp>
+#include <ymir/Dungeon/CaveRoomGenerator.hpp>
+#include <ymir/Dungeon/Context.hpp>
+#include <ymir/Dungeon/RectRoomGenerator.hpp>
+#include <ymir/Dungeon/RoomPlacer.hpp>
+#include <ymir/LayeredMap.hpp>
+#include <ymir/Noise.hpp>
+
+using namespace ymir;
+using namespace ymir::Dungeon;
+
+namespace {
+
+ymir::Config::AnyDict getCfg() {
+  ymir::Config::AnyDict Cfg;
+  Cfg["dungeon/seed"] = 11u;
+  Cfg["dungeon/wall"] = '#';
+  Cfg["room_generator/room_size_min_max"] = Rect2d<int>{{5, 5}, {10, 10}};
+  Cfg["room_placer/layer"] = std::string("ground");
+  Cfg["room_placer/room_generator"] = std::string("rect_room_generator");
+  Cfg["room_placer/num_new_room_attempts"] = 30u;
+  return Cfg;
+}
+
+template <typename Alloc>
+void runRoomPlacer(Context<char, int, Alloc> &Ctx,
+                   ymir::Config::AnyDict Cfg = getCfg()) {
+  BuilderPass Pass;
+  Pass.registerBuilder<RectRoomGenerator<char, int, WyHashRndEng, Alloc>>();
+  Pass.registerBuilder<CaveRoomGenerator<char, int, WyHashRndEng, Alloc>>();
+  Pass.registerBuilder<RoomPlacer<char, int, WyHashRndEng, Alloc>>();
+  Pass.setSequence({"room_placer"});
+  Pass.configure(std::move(Cfg));
+  Ctx.Map.get("ground").fill('#');
+  Pass.init(Ctx);
+  Pass.run(Ctx);
+}
+
+TEST(DungeonRoomPlacerTest, PmrContextAllocatesFromMapResource) {
+  LayeredMap<char, int> Map({"ground"}, {60, 40});
+  Context<char, int> Ctx(Map);
+  runRoomPlacer(Ctx);
+
+  std::pmr::monotonic_buffer_resource Arena;
+  pmr::LayeredMap<char, int> PmrMap({"ground"}, {60, 40}, &Arena);
+  Context<char, int, std::pmr::polymorphic_allocator<char>> PmrCtx(PmrMap);
+  runRoomPlacer(PmrCtx);
+
+  // The allocator only changes where the dungeon lives, not its layout
+  const auto &Ground = Map.get("ground");
+  const auto &PmrGround = PmrMap.get("ground");
+  EXPECT_TRUE(std::equal(Ground.begin(), Ground.end(), PmrGround.begin(),
+                         PmrGround.end()));
+  ASSERT_EQ(PmrCtx.Rooms.size(), Ctx.Rooms.size());
+  ASSERT_EQ(PmrCtx.Hallways.size(), Ctx.Hallways.size());
+  ASSERT_GT(PmrCtx.Rooms.size(), 1u);
+
+  EXPECT_EQ(PmrCtx.Rooms.get_allocator().resource(), &Arena);
+  EXPECT_EQ(PmrCtx.Hallways.get_allocator().resource(), &Arena);
+  for (const auto &Room : PmrCtx.Rooms) {
+    EXPECT_EQ(Room.M.get_allocator().resource(), &Arena);
+    EXPECT_EQ(Room.Doors.get_allocator().resource(), &Arena);
+  }
+}
+
+TEST(DungeonRoomPlacerTest, PmrContextWithCaveRooms) {
+  // Cave rooms from the threshold rule and from a life-like rule
+  auto Cfg = getCfg();
+  Cfg["room_placer/room_generator"] = std::string("cave_room_generator");
+  auto RuleCfg = Cfg;
+  RuleCfg["cave_room_generator/ca_rule"] = std::string("B5678/S45678");
+
+  for (const auto &C : {Cfg, RuleCfg}) {
+    LayeredMap<char, int> Map({"ground"}, {60, 40});
+    Context<char, int> Ctx(Map);
+    runRoomPlacer(Ctx, C);
+
+    std::pmr::monotonic_buffer_resource Arena;
+    pmr::LayeredMap<char, int> PmrMap({"ground"}, {60, 40}, &Arena);
+    Context<char, int, std::pmr::polymorphic_allocator<char>> PmrCtx(PmrMap);
+    runRoomPlacer(PmrCtx, C);
+
+    const auto &Ground = Map.get("ground");
+    const auto &PmrGround = PmrMap.get("ground");
+    EXPECT_TRUE(std::equal(Ground.begin(), Ground.end(), PmrGround.begin(),
+                           PmrGround.end()));
+    ASSERT_EQ(PmrCtx.Rooms.size(), Ctx.Rooms.size());
+    ASSERT_GT(PmrCtx.Rooms.size(), 1u);
+    for (const auto &Room : PmrCtx.Rooms) {
+      EXPECT_EQ(Room.M.get_allocator().resource(), &Arena);
+    }
+  }
+}
+
+} // namespace
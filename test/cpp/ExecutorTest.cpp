@@ -0,0 +1,128 @@
+#include "TestHelpers.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <ymir/Executor.hpp>
+#include <ymir/Map.hpp>
+
+namespace {
+
+static_assert(ymir::IsExecutorV<ymir::SequentialExecutor>);
+static_assert(ymir::IsExecutorV<ymir::ThreadPoolExecutor>);
+static_assert(!ymir::IsExecutorV<int>);
+
+TEST(ExecutorTest, ThreadPoolRunsAllTasks) {
+  ymir::ThreadPoolExecutor Pool(4);
+  EXPECT_EQ(Pool.getNumWorkers(), 4);
+  for (int Round = 0; Round < 10; Round++) {
+    std::vector<std::atomic<int>> Counts(100);
+    Pool.run(Counts.size(), [&Counts](std::size_t Idx) { Counts[Idx]++; });
+    for (const auto &Count : Counts) {
+      EXPECT_EQ(Count, 1);
+    }
+  }
+  Pool.run(0, [](std::size_t) { FAIL(); });
+}
+
+TEST(ExecutorTest, ThreadPoolPropagatesException) {
+  ymir::ThreadPoolExecutor Pool(3);
+  std::atomic<int> Count = 0;
+  EXPECT_THROW(Pool.run(20,
+                        [&Count](std::size_t Idx) {
+                          Count++;
+                          if (Idx == 7) {
+                            throw std::runtime_error("task failed");
+                          }
+                        }),
+               std::runtime_error);
+  EXPECT_EQ(Count, 20);
+  // Pool is still usable afterwards
+  Pool.run(5, [&Count](std::size_t) { Count++; });
+  EXPECT_EQ(Count, 25);
+}
+
+TEST(ExecutorTest, RowBands) {
+  ymir::ThreadPoolExecutor Pool(2);
+  const ymir::Rect2d<int> Rect{{2, 3}, {5, 11}};
+  auto Bands = ymir::getRowBands(Pool, Rect);
+  ASSERT_EQ(Bands.size(), 8);
+  int NextY = Rect.Pos.Y;
+  for (const auto &Band : Bands) {
+    EXPECT_EQ(Band.Pos, ymir::Point2d<int>(2, NextY));
+    EXPECT_EQ(Band.Size.W, 5);
+    NextY += Band.Size.H;
+  }
+  EXPECT_EQ(NextY, Rect.Pos.Y + Rect.Size.H);
+  EXPECT_EQ(ymir::getRowBands(Pool, ymir::Rect2d<int>{{0, 0}, {5, 3}}).size(),
+            3);
+  EXPECT_TRUE(ymir::getRowBands(Pool, ymir::Rect2d<int>{{0, 0}, {5, 0}})
+                  .empty());
+
+  // Aligned bands start at multiples of the alignment and cover all rows
+  const ymir::Rect2d<int> AlignRect{{0, 3}, {5, 30}};
+  Bands = ymir::getRowBands(Pool, AlignRect, 8);
+  ASSERT_EQ(Bands.size(), 5);
+  NextY = AlignRect.Pos.Y;
+  for (const auto &Band : Bands) {
+    EXPECT_EQ(Band.Pos.Y, NextY);
+    EXPECT_TRUE(Band.Pos.Y == AlignRect.Pos.Y || Band.Pos.Y % 8 == 0);
+    NextY += Band.Size.H;
+  }
+  EXPECT_EQ(NextY, AlignRect.Pos.Y + AlignRect.Size.H);
+}
+
+TEST(ExecutorTest, ParallelMapOperations) {
+  ymir::ThreadPoolExecutor Pool(4);
+  auto Map = makeRandomMap({67, 45}, 42, 0.5f);
+
+  EXPECT_EQ(Map.findTiles(Pool, ' '), Map.findTiles(' '));
+  ymir::SequentialExecutor Seq;
+  EXPECT_EQ(Map.findTiles(Seq, '#'), Map.findTiles('#'));
+
+  std::atomic<int> Walls = 0;
+  const auto &ConstMap = Map;
+  ConstMap.forEachElem(Pool, [&Walls](char Tile) { Walls += Tile == '#'; });
+  EXPECT_EQ(Walls, Map.findTiles('#').size());
+
+  auto Expected = Map;
+  const ymir::Rect2d<int> Rect{{3, 4}, {50, 30}};
+  const auto Mark = [](auto Pos, char &Tile) {
+    if (Tile == ' ') {
+      Tile = 'a' + Pos.X % 10;
+    }
+  };
+  Expected.forEach(Mark, Rect);
+  Map.forEach(Pool, Mark, Rect);
+  EXPECT_MAP_EQ(Map, Expected);
+
+  Expected.fillRect('x', ymir::Rect2d<int>{{10, 10}, {20, 20}});
+  Map.fillRect(Pool, 'x', ymir::Rect2d<int>{{10, 10}, {20, 20}});
+  EXPECT_MAP_EQ(Map, Expected);
+
+  Expected.replaceTile('#', '.');
+  Map.replaceTile(Pool, '#', '.');
+  EXPECT_MAP_EQ(Map, Expected);
+
+  Map.forEachElem(Pool, [](char &Tile) { Tile = '-'; });
+  EXPECT_TRUE(Map.findTilesNot('-').empty());
+}
+
+TEST(ExecutorTest, ParallelBoolMapOperations) {
+  // Bands of a bit-packed Map<bool> must not share storage words
+  ymir::ThreadPoolExecutor Pool(4);
+  for (const auto &Size : {ymir::Size2d<int>{3, 64}, {67, 45}, {64, 9}}) {
+    ymir::Map<bool, int> Map(Size), Expected(Size);
+    Map.fill(false);
+    Expected.fill(false);
+    const ymir::Rect2d<int> Rect{{1, 2}, {Size.W - 1, Size.H - 3}};
+    Map.fillRect(Pool, true, Rect);
+    Expected.fillRect(true, Rect);
+    EXPECT_EQ(Map.findTiles(Pool, true), Expected.findTiles(true));
+    Map.replaceTile(Pool, true, false);
+    EXPECT_TRUE(Map.findTiles(true).empty());
+    Map.replaceTile(Pool, false, true);
+    EXPECT_TRUE(Map.findTiles(false).empty());
+  }
+}
+
+} // namespace
@@ -0,0 +1,91 @@
+#include "TestHelpers.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <ymir/IndexedMap.hpp>
+#include <ymir/Map.hpp>
+#include <ymir/MapIo.hpp>
+#include <ymir/Noise.hpp>
+
+namespace {
+
+template <typename T> std::vector<T> sorted(std::vector<T> Vec) {
+  std::sort(Vec.begin(), Vec.end());
+  return Vec;
+}
+
+TEST(IndexedMapTest, CountAndFind) {
+  ymir::IndexedMap<char, int> IM(ymir::loadMap({
+      "#####",
+      "#@ <#",
+      "#####",
+  }));
+  EXPECT_EQ(IM.count('#'), 12);
+  EXPECT_EQ(IM.count('@'), 1);
+  EXPECT_EQ(IM.count('x'), 0);
+  EXPECT_TRUE(IM.positions('x').empty());
+  EXPECT_EQ(IM.findTiles('#'), IM.getMap().findTiles('#'));
+
+  IM.setTile({1, 1}, ' ');
+  IM.setTile({3, 1}, '@');
+  EXPECT_EQ(IM.count('@'), 1);
+  EXPECT_EQ(IM.count('<'), 0);
+  EXPECT_EQ(IM.count(' '), 2);
+  EXPECT_EQ(IM.positions('@'), (std::vector<ymir::Point2d<int>>{{3, 1}}));
+  EXPECT_THROW(IM.setTile({5, 0}, ' '), std::out_of_range);
+
+  IM.fillRect('.', ymir::Rect2d<int>{{0, 0}, {2, 3}});
+  EXPECT_EQ(IM.count('.'), 6);
+  EXPECT_EQ(IM.count('#'), 7);
+
+  IM.fill('x');
+  EXPECT_EQ(IM.count('x'), 15);
+  EXPECT_EQ(IM.count('.'), 0);
+}
+
+TEST(IndexedMapTest, MatchesMapAfterRandomUpdates) {
+  auto Map = makeRandomMap({31, 17}, 42, 0.5f);
+  std::mt19937 RndEng(42);
+  ymir::IndexedMap<char, int> IM(Map);
+
+  const std::string Tiles = "# .@";
+  std::uniform_int_distribution<int> TileDist(0, Tiles.size() - 1);
+  for (int Idx = 0; Idx < 2000; Idx++) {
+    auto Pos = ymir::randomPoint2d(Map.rect(), RndEng);
+    auto Tile = Tiles.at(TileDist(RndEng));
+    Map.setTile(Pos, Tile);
+    IM.setTile(Pos, Tile);
+  }
+  auto Room = ymir::loadMap({"@@@", "@.@", "@@@"});
+  Map.merge(Room, {29, 15});
+  IM.merge(Room, {29, 15});
+
+  EXPECT_MAP_EQ(IM.getMap(), Map);
+  for (char Tile : Tiles) {
+    EXPECT_EQ(IM.count(Tile), Map.findTiles(Tile).size()) << Tile;
+    EXPECT_EQ(sorted(IM.positions(Tile)), sorted(Map.findTiles(Tile)))
+        << Tile;
+    EXPECT_EQ(IM.findTiles(Tile), Map.findTiles(Tile)) << Tile;
+  }
+}
+
+TEST(IndexedMapTest, Classifier) {
+  auto IsWalkable = [](char Tile) { return Tile == ' ' || Tile == '.'; };
+  ymir::IndexedMap<char, int, decltype(IsWalkable)> IM(
+      ymir::loadMap({
+          "#####",
+          "# . #",
+          "#####",
+      }),
+      IsWalkable);
+  EXPECT_EQ(IM.count(true), 3);
+  EXPECT_EQ(IM.count(false), 12);
+  IM.setTile({2, 1}, ' ');
+  EXPECT_EQ(IM.count(true), 3);
+  IM.setTile({2, 1}, '#');
+  EXPECT_EQ(IM.count(true), 2);
+  EXPECT_EQ(IM.findTiles(true),
+            (std::vector<ymir::Point2d<int>>{{1, 1}, {3, 1}}));
+}
+
+} // namespace
@@ -1,5 +1,6 @@
 #include "TestHelpers.hpp"
 #include <gtest/gtest.h>
+#include <memory_resource>
 #include <ymir/LayeredMap.hpp>
 #include <ymir/Map.hpp>
 #include <ymir/MapIo.hpp>
@@ -27,4 +28,22 @@ TEST(LayeredMapTest, Render) {
   EXPECT_MAP_EQ(RenderedMap, RefRenderedMap);
 }
 
-} // namespace
\ No newline at end of file
+TEST(LayeredMapTest, PmrAllocation) {
+  std::pmr::monotonic_buffer_resource Arena;
+  ymir::pmr::LayeredMap<char, int> LM({"walls", "objects"}, {3, 3}, &Arena);
+  EXPECT_EQ(LM.get_allocator().resource(), &Arena);
+  for (const auto &Layer : LM.getLayers()) {
+    EXPECT_EQ(Layer.get_allocator().resource(), &Arena);
+  }
+  LM.get("walls").fill('#');
+  LM.get("objects").fill(' ');
+  LM.get("objects").setTile({1, 1}, 'x');
+  LM.get("walls").setTile({1, 1}, ' ');
+
+  auto RenderedMap = LM.render(' ');
+  EXPECT_EQ(RenderedMap.get_allocator().resource(), &Arena);
+  EXPECT_EQ(RenderedMap.getTile({1, 1}), 'x');
+  EXPECT_EQ(RenderedMap.getTile({0, 1}), '#');
+}
+
+} // namespace
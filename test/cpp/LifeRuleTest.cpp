@@ -0,0 +1,105 @@
+#include "TestHelpers.hpp"
+#include <gtest/gtest.h>
+#include <ymir/BitMap.hpp>
+#include <ymir/CallularAutomata.hpp>
+#include <ymir/Executor.hpp>
+#include <ymir/LifeRule.hpp>
+#include <ymir/Map.hpp>
+#include <ymir/MapIo.hpp>
+
+namespace {
+
+using ymir::celat::LifeRule;
+
+TEST(LifeRuleTest, Parse) {
+  constexpr auto Life = LifeRule::parse("B3/S23");
+  static_assert(Life.Birth == (1 << 3));
+  static_assert(Life.Survive == ((1 << 2) | (1 << 3)));
+  EXPECT_EQ(LifeRule::parse("b5678/s45678"), (LifeRule{0x1e0, 0x1f0}));
+  EXPECT_EQ(LifeRule::parse("B/S"), LifeRule());
+  EXPECT_THROW(LifeRule::parse("S23"), std::runtime_error);
+  EXPECT_THROW(LifeRule::parse("B3"), std::runtime_error);
+  EXPECT_THROW(LifeRule::parse("B39/S23"), std::runtime_error);
+  EXPECT_THROW(LifeRule::parse("B3/S2/S3"), std::runtime_error);
+
+  using Cave = ymir::celat::CaveLifeRule;
+  const auto CaveRule = LifeRule::parse("B5678/S45678");
+  for (unsigned N = 0; N <= 8; N++) {
+    EXPECT_EQ(Cave::births(N), CaveRule.births(N)) << N;
+    EXPECT_EQ(Cave::survives(N), CaveRule.survives(N)) << N;
+  }
+}
+
+TEST(LifeRuleTest, Blinker) {
+  auto M = ymir::loadMap({
+      ".....",
+      "..#..",
+      "..#..",
+      "..#..",
+      ".....",
+  });
+  const auto Life = LifeRule::parse("B3/S23");
+  ymir::celat::applyLifeRule(M, '#', '.', Life);
+  EXPECT_MAP_EQ(M, ymir::loadMap({
+                       ".....",
+                       ".....",
+                       ".###.",
+                       ".....",
+                       ".....",
+                   }));
+  ymir::celat::applyLifeRule(M, '#', '.', Life, 3);
+  EXPECT_MAP_EQ(M, ymir::loadMap({
+                       ".....",
+                       "..#..",
+                       "..#..",
+                       "..#..",
+                       ".....",
+                   }));
+}
+
+TEST(LifeRuleTest, MatchesThresholdRules) {
+  // Widths around the word size to cover the neighbors across words
+  for (const int Width : {7, 64, 130}) {
+    auto M = makeRandomMap({Width, 29}, 5, 0.55f);
+    auto Ref = M;
+    const ymir::Rect2d<int> Rect{{1, 2}, {Width - 3, 25}};
+
+    ymir::celat::Automaton<int> CA;
+    CA.replace(Ref, ' ', '#', 4, 6, Rect);
+    ymir::celat::applyLifeRule(M, ' ', '#', LifeRule::parse("B/S45678"), 6,
+                               Rect);
+    EXPECT_EQ(M, Ref) << Width;
+
+    CA.generate(Ref, ' ', 5);
+    ymir::celat::applyLifeRule(
+        M, ' ', '#', ymir::celat::StaticLifeRule<0x1e0, 0x1ff>());
+    EXPECT_EQ(M, Ref) << Width;
+  }
+}
+
+TEST(LifeRuleTest, KeepsPaddingClear) {
+  ymir::BitMap<int> BM(70, 3);
+  BM.setTile({69, 1}, true);
+  // Every dead cell is born, the unused bits of the row must stay unset
+  ymir::celat::runLife(BM, LifeRule::parse("B012345678/S"));
+  EXPECT_EQ(BM.count(), 70u * 3u - 1u);
+  ymir::celat::runLife(BM, LifeRule::parse("B012345678/S"));
+  EXPECT_EQ(BM.count(), 1u);
+  EXPECT_TRUE(BM.getTile({69, 1}));
+}
+
+TEST(LifeRuleTest, ThreadPoolMatchesSequential) {
+  ymir::ThreadPoolExecutor Pool(3);
+  const auto M = makeRandomMap({150, 41}, 23, 0.55f);
+  auto BM = ymir::BitMap<int>::fromMap(M, ' ');
+  auto Ref = BM;
+  const ymir::Rect2d<int> Rect{{10, 2}, {100, 37}};
+  ymir::celat::runLife(Pool, BM, LifeRule::parse("B5678/S45678"), 7, Rect);
+  ymir::celat::runLife(Ref, LifeRule::parse("B5678/S45678"), 7, Rect);
+  EXPECT_EQ(BM, Ref);
+  ymir::celat::runLife(Pool, BM, ymir::celat::CaveLifeRule(), 3);
+  ymir::celat::runLife(Ref, ymir::celat::CaveLifeRule(), 3);
+  EXPECT_EQ(BM, Ref);
+}
+
+} // namespace
@@ -1,4 +1,8 @@
+#include "TestHelpers.hpp"
+#include <array>
 #include <gtest/gtest.h>
+#include <memory_resource>
+#include <string>
 #include <ymir/Map.hpp>
 #include <ymir/MapIo.hpp>
 
@@ -18,4 +22,142 @@ TEST(MapTest, MinMax) {
   EXPECT_EQ(Map.toPos(MaxElem), ymir::Point2d<int>(1, 1));
 }
 
-}
\ No newline at end of file
+TEST(MapTest, UncheckedAccess) {
+  auto Map = ymir::loadMap({
+      "abc",
+      "def",
+      "ghi",
+  });
+  EXPECT_EQ(Map.index({0, 0}), 0);
+  EXPECT_EQ(Map.index({2, 1}), 5);
+  EXPECT_EQ(Map.getTileUnchecked({1, 1}), 'e');
+  EXPECT_EQ(Map[2], 'c');
+  EXPECT_EQ(std::string(Map.row(1), Map.row(1) + Map.getSize().W), "def");
+
+  Map.setTileUnchecked({0, 1}, 'x');
+  Map[2] = 'y';
+  Map.row(0)[0] = 'z';
+  auto MapRef = ymir::loadMap({
+      "zby",
+      "xef",
+      "ghi",
+  });
+  EXPECT_MAP_EQ(Map, MapRef);
+}
+
+TEST(MapTest, IsTile) {
+  auto Map = ymir::loadMap({
+      "# #",
+      "#x#",
+      "###",
+  });
+  EXPECT_TRUE(Map.isTile({1, 1}, 'x'));
+  EXPECT_FALSE(Map.isTile({1, 0}, '#'));
+  EXPECT_FALSE(Map.isTile({1, 3}, '#'));
+  EXPECT_FALSE(Map.isTile({0, -1}, '#'));
+}
+
+TEST(MapTest, ForEachRect) {
+  auto Map = ymir::loadMap({
+      "abcd",
+      "efgh",
+      "ijkl",
+  });
+  std::string Tiles;
+  std::vector<ymir::Point2d<int>> Positions;
+  Map.forEach(
+      [&Tiles, &Positions](auto Pos, char Tile) {
+        Tiles += Tile;
+        Positions.push_back(Pos);
+      },
+      ymir::Rect2d<int>{{2, 1}, {5, 5}});
+  EXPECT_EQ(Tiles, "ghkl");
+  EXPECT_EQ(Positions, (std::vector<ymir::Point2d<int>>{
+                           {2, 1}, {3, 1}, {2, 2}, {3, 2}}));
+
+  Tiles.clear();
+  Map.forEachElem([&Tiles](char Tile) { Tiles += Tile; },
+                  ymir::Rect2d<int>{{-1, -1}, {2, 4}});
+  EXPECT_EQ(Tiles, "aei");
+}
+
+TEST(MapTest, Merge) {
+  auto Map = ymir::loadMap({
+      "....",
+      "....",
+      "....",
+  });
+  auto Other = ymir::loadMap({
+      "ab",
+      "cd",
+      "ef",
+  });
+  Map.merge(Other, {3, 2});
+  Map.merge(Other, {-1, -1});
+  auto MapRef = ymir::loadMap({
+      "d...",
+      "f...",
+      "...a",
+  });
+  EXPECT_MAP_EQ(Map, MapRef);
+}
+
+TEST(MapTest, PmrAllocation) {
+  std::array<std::byte, 4096> Buffer;
+  std::pmr::monotonic_buffer_resource Arena(Buffer.data(), Buffer.size(),
+                                            std::pmr::null_memory_resource());
+  ymir::pmr::Map<char, int> Map(10, 10, &Arena);
+  EXPECT_EQ(Map.get_allocator().resource(), &Arena);
+  Map.fill('.');
+  Map.setTile({3, 4}, '#');
+  EXPECT_EQ(Map.findTiles('#'), (std::vector<ymir::Point2d<int>>{{3, 4}}));
+
+  auto *Tile = &Map.getTile({0, 0});
+  EXPECT_GE(reinterpret_cast<std::byte *>(Tile), Buffer.data());
+  EXPECT_LT(reinterpret_cast<std::byte *>(Tile), Buffer.data() + Buffer.size());
+
+  // Copy into the default resource
+  ymir::pmr::Map<char, int> Copy(Map, std::pmr::get_default_resource());
+  EXPECT_EQ(Copy.get_allocator().resource(), std::pmr::get_default_resource());
+  EXPECT_EQ(Copy, Map);
+}
+
+TEST(MapTest, NonTrivialTiles) {
+  ymir::Map<std::string, int> Map(4, 3);
+  Map.fill("a");
+  Map.fillRect("b", ymir::Rect2d<int>{{1, 1}, {5, 5}});
+  ymir::Map<std::string, int> Other(2, 2);
+  Other.fill("c");
+  Map.merge(Other, {-1, -1});
+  EXPECT_EQ(Map.getTile({0, 0}), "c");
+  EXPECT_EQ(Map.getTile({1, 0}), "a");
+  EXPECT_EQ(Map.getTile({3, 2}), "b");
+  EXPECT_EQ(Map.findTiles("b").size(), 6);
+
+  auto Copy = Map;
+  EXPECT_TRUE(Copy == Map);
+  Copy.setTile({3, 2}, "d");
+  EXPECT_FALSE(Copy == Map);
+}
+
+TEST(MapTest, BoolTiles) {
+  // std::vector<bool> has no addressable tiles, merge copies tile by tile
+  ymir::Map<bool, int> Map(4, 4), Other(2, 2);
+  Map.fill(false);
+  Other.fill(true);
+  Other.setTile({0, 1}, false);
+  Map.merge(Other, {3, 2});
+  Map.merge(Other, {-1, -1});
+  EXPECT_EQ(Map.findTiles(true),
+            (std::vector<ymir::Point2d<int>>{{0, 0}, {3, 2}}));
+  Map.merge(Other);
+  EXPECT_EQ(Map.findTiles(true).size(), 4u);
+  EXPECT_FALSE(Map.getTile({0, 1}));
+
+  Map.fillRect(true, ymir::Rect2d<int>{{1, 1}, {2, 3}});
+  EXPECT_EQ(Map.findTiles(true).size(), 9u);
+  EXPECT_TRUE(Map.getTile({2, 3}));
+  EXPECT_FALSE(Map.getTile({3, 3}));
+}
+
+} // namespace
@@ -0,0 +1,112 @@
+#include "TestHelpers.hpp"
+#include <gtest/gtest.h>
+#include <ymir/Algorithm/Dijkstra.hpp>
+#include <ymir/CallularAutomata.hpp>
+#include <ymir/Map.hpp>
+#include <ymir/MapIo.hpp>
+#include <ymir/MapView.hpp>
+
+namespace {
+
+TEST(MapViewTest, ViewAccess) {
+  auto Map = ymir::loadMap({
+      "#####",
+      "#abc#",
+      "#def#",
+      "#####",
+  });
+  auto View = Map.view(ymir::Rect2d<int>{{1, 1}, {3, 2}});
+  EXPECT_EQ(View.getSize(), ymir::Size2d<int>(3, 2));
+  EXPECT_EQ(View.getStride(), 5);
+  EXPECT_EQ(View.getTile({0, 0}), 'a');
+  EXPECT_EQ(View.getTile({2, 1}), 'f');
+  EXPECT_THROW(View.getTile({3, 0}), std::out_of_range);
+  EXPECT_FALSE(View.isTile({3, 0}, '#'));
+  EXPECT_EQ(View.getNeighborCount({1, 0}, '#'), 0);
+  EXPECT_EQ(dump(View), "abc\ndef\n");
+  EXPECT_EQ(View.findTiles('e'), (std::vector<ymir::Point2d<int>>{{1, 1}}));
+
+  auto Sub = View.subview({{1, 0}, {4, 4}});
+  EXPECT_EQ(Sub.getSize(), ymir::Size2d<int>(2, 2));
+  EXPECT_EQ(dump(Sub), "bc\nef\n");
+
+  // Clipped to the map
+  EXPECT_EQ(Map.view(ymir::Rect2d<int>{{3, 2}, {4, 4}}).getSize(),
+            ymir::Size2d<int>(2, 2));
+  EXPECT_TRUE(Map.view(ymir::Rect2d<int>{{5, 0}, {1, 1}}).empty());
+
+  // Writes go to the underlying map
+  Sub.fill('x');
+  View.setTile({0, 1}, 'y');
+  EXPECT_MAP_EQ(Map, ymir::loadMap({
+                         "#####",
+                         "#axx#",
+                         "#yxx#",
+                         "#####",
+                     }));
+
+  ymir::MapView<const char, int> ConstView = View;
+  EXPECT_EQ(ConstView.getTile({0, 0}), 'a');
+  EXPECT_MAP_EQ(ConstView.toMap(),
+                ymir::loadMap(std::vector<std::string>{"axx", "yxx"}));
+}
+
+TEST(MapViewTest, Merge) {
+  auto Map = ymir::loadMap({
+      "....",
+      "....",
+      "....",
+  });
+  const auto Other = ymir::loadMap({
+      "abc",
+      "def",
+      "ghi",
+  });
+  Map.merge(Other.view(ymir::Rect2d<int>{{1, 1}, {2, 2}}), {2, 0});
+  EXPECT_MAP_EQ(Map, ymir::loadMap({
+                         "..ef",
+                         "..hi",
+                         "....",
+                     }));
+  Map.view(ymir::Rect2d<int>{{0, 1}, {2, 2}}).merge(Other.view(), {-1, -1});
+  EXPECT_MAP_EQ(Map, ymir::loadMap({
+                         "..ef",
+                         "efhi",
+                         "hi..",
+                     }));
+}
+
+TEST(MapViewTest, CellularAutomataOnView) {
+  auto Map = makeRandomMap({40, 20}, 42, 0.65f);
+
+  const ymir::Rect2d<int> Rect{{5, 3}, {30, 12}};
+  auto Expected = Map.view(Rect).toMap();
+  ymir::celat::replace(Expected, ' ', '#', 4);
+  ymir::celat::generate(Expected, ' ', 5);
+
+  auto Before = Map;
+  auto View = Map.view(Rect);
+  ymir::celat::replace(View, ' ', '#', 4);
+  ymir::celat::generate(View, ' ', 5);
+  EXPECT_MAP_EQ(View.toMap(), Expected);
+
+  // Nothing outside of the view was touched
+  Before.merge(Expected, Rect.Pos);
+  EXPECT_MAP_EQ(Map, Before);
+}
+
+TEST(MapViewTest, DijkstraIntoView) {
+  ymir::Map<int, int> DM(6, 6);
+  DM.fill(-2);
+  auto View = DM.view(ymir::Rect2d<int>{{1, 1}, {3, 3}});
+  ymir::Algorithm::fillDijkstraMap(
+      View, std::vector<ymir::Point2d<int>>{{0, 0}}, [](auto) { return false; });
+  EXPECT_EQ(View.getTile({2, 2}), 4);
+  EXPECT_EQ(DM.getTile({3, 3}), 4);
+  EXPECT_EQ(DM.getTile({4, 4}), -2);
+  auto Path = ymir::Algorithm::getPathFromDijkstraMap(
+      View, ymir::Point2d<int>{0, 0}, ymir::Point2d<int>{2, 2});
+  EXPECT_EQ(Path.size(), 4);
+}
+
+} // namespace
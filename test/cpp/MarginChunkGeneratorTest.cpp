@@ -0,0 +1,105 @@
+#include "TestHelpers.hpp"
+#include <functional>
+#include <gtest/gtest.h>
+#include <vector>
+#include <ymir/CallularAutomata.hpp>
+#include <ymir/ChunkedMap.hpp>
+#include <ymir/Map.hpp>
+#include <ymir/MarginChunkGenerator.hpp>
+#include <ymir/Noise.hpp>
+
+namespace {
+
+using ChunkType = ymir::Map<char, int>;
+
+void generateBase(ChunkType &M, ymir::Point2d<int> Origin) {
+  M.fill('#');
+  ymir::WyHashRndEng RndEng;
+  ymir::fillRectSeedRandom(M, ' ', 0.6f, RndEng, {}, Origin);
+}
+
+// Four replacement and one smoothing generation, each reads the neighbors
+std::vector<std::function<void(ChunkType &)>> getCaveGenerations() {
+  std::vector<std::function<void(ChunkType &)>> Generations(
+      4, [](ChunkType &M) {
+        ymir::celat::Automaton<int> CA;
+        CA.replace(M, ' ', '#', 4);
+      });
+  Generations.emplace_back([](ChunkType &M) {
+    ymir::celat::Automaton<int> CA;
+    CA.generate(M, ' ', 5);
+  });
+  return Generations;
+}
+
+void runCaves(ChunkType &M) {
+  for (const auto &Gen : getCaveGenerations()) {
+    Gen(M);
+  }
+}
+
+TEST(MarginChunkGeneratorTest, ChunksMatchUnboundedMap) {
+  std::size_t BaseChunks = 0;
+  std::size_t GeneratedTiles = 0;
+  auto Generations = getCaveGenerations();
+  for (auto &Step : Generations) {
+    Step = [&GeneratedTiles, Step](ChunkType &M) {
+      GeneratedTiles += M.getSize().W * M.getSize().H;
+      Step(M);
+    };
+  }
+  ymir::MarginChunkGenerator<char> Gen(
+      {16, 12},
+      [&BaseChunks](ChunkType &M, ymir::Point2d<int> Origin) {
+        BaseChunks++;
+        generateBase(M, Origin);
+      },
+      std::move(Generations));
+  ymir::ChunkedMap<char> World({16, 12}, std::ref(Gen));
+  EXPECT_EQ(Gen.getMargin(), 5);
+
+  // Reference on a single map much larger than the margin around the rect
+  const ymir::Rect2d<int> Rect{{-40, -30}, {80, 60}};
+  const ymir::Point2d<int> RefOrigin{-60, -50};
+  ChunkType Ref(120, 100);
+  generateBase(Ref, RefOrigin);
+  runCaves(Ref);
+  const auto Cropped =
+      Ref.view(ymir::Rect2d<int>{Rect.Pos - RefOrigin, Rect.Size}).toMap();
+  EXPECT_MAP_EQ(World.copyRect(Rect), Cropped);
+
+  // The 6x6 chunks read one more ring of chunks on their top-left side from
+  // each previous generation
+  EXPECT_EQ(World.getLoadedChunkCount(), 36u);
+  for (std::size_t Idx = 0; Idx < 5; Idx++) {
+    const std::size_t Side = 6 + 5 - Idx;
+    EXPECT_EQ(Gen.getGenerationMap(Idx).getLoadedChunkCount(), Side * Side);
+  }
+  EXPECT_EQ(BaseChunks, 121u);
+
+  // Scrolling by a chunk only generates the new chunks of each generation,
+  // the margins come from the cached chunks of the previous generation
+  const ymir::Rect2d<int> Scrolled{Rect.Pos + ymir::Point2d<int>{16, 0},
+                                   Rect.Size};
+  World.copyRect(Scrolled);
+  std::size_t Chunks = World.getLoadedChunkCount();
+  for (std::size_t Idx = 1; Idx < 5; Idx++) {
+    Chunks += Gen.getGenerationMap(Idx).getLoadedChunkCount();
+  }
+  EXPECT_EQ(World.getLoadedChunkCount(), 42u);
+  EXPECT_EQ(BaseChunks, 132u);
+  EXPECT_EQ(GeneratedTiles, Chunks * 18u * 14u);
+}
+
+TEST(MarginChunkGeneratorTest, NoGenerations) {
+  ymir::MarginChunkGenerator<char> Gen({16, 12}, generateBase, {});
+  ymir::ChunkedMap<char> World({16, 12}, std::ref(Gen));
+  EXPECT_EQ(Gen.getMargin(), 0);
+
+  const ymir::Rect2d<int> Rect{{-20, -10}, {40, 30}};
+  ChunkType Ref(Rect.Size);
+  generateBase(Ref, Rect.Pos);
+  EXPECT_MAP_EQ(World.copyRect(Rect), Ref);
+}
+
+} // namespace
@@ -1,5 +1,12 @@
 #include "TestHelpers.hpp"
+#include <algorithm>
+#include <cmath>
 #include <gtest/gtest.h>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+#include <ymir/BitMap.hpp>
 #include <ymir/Map.hpp>
 #include <ymir/Noise.hpp>
 #include <ymir/Algorithm/MapAlgebra.hpp>
@@ -33,6 +40,12 @@ ymir::Map<char, int> toCharMap(const ymir::Map<float, int> &NoiseMap) {
   return M;
 }
 
+std::size_t countTiles(const ymir::Map<char, int> &M, char Tile) {
+  std::size_t Count = 0;
+  M.forEachElem([&Count, Tile](char T) { Count += T == Tile; });
+  return Count;
+}
+
 TEST(NoiseTest, SimplexNoiseMap) {
   auto NoiseMap = ymir::Simplex::generateNoiseMap<int>({20, 20}, {0, 0}, 0,
                                                        64.0f, 6, 0.5f, 2.0f);
@@ -100,6 +113,335 @@ TEST(NoiseTest, SimplexNoiseMapOverlayed) {
   EXPECT_MAP_EQ(Map, MapRef);
 }
 
+TEST(NoiseTest, SimplexBatchMatchesScalar) {
+  // Not a multiple of the batch width, negative and integral coordinates hit
+  // the lattice edges of the simplices
+  const std::size_t N = 1003;
+  std::mt19937 RndEng(3);
+  std::uniform_real_distribution<float> Dist(-300.0f, 300.0f);
+  std::vector<float> X(N), Y(N), Z(N), Out(N);
+  for (std::size_t Idx = 0; Idx < N; Idx++) {
+    X[Idx] = Idx % 7 == 0 ? std::floor(Dist(RndEng)) : Dist(RndEng);
+    Y[Idx] = Idx % 5 == 0 ? X[Idx] : Dist(RndEng);
+    Z[Idx] = Idx % 3 == 0 ? 0.0f : Dist(RndEng);
+  }
+  for (const unsigned Octaves : {1, 6}) {
+    ymir::Simplex::noise2dBatch(X.data(), Y.data(), Out.data(), N, Octaves,
+                                0.5f, 2.0f);
+    for (std::size_t Idx = 0; Idx < N; Idx++) {
+      EXPECT_EQ(Out[Idx], ymir::Simplex::noise2d(X[Idx], Y[Idx], Octaves,
+                                                 0.5f, 2.0f))
+          << Idx;
+    }
+    ymir::Simplex::noise3dBatch(X.data(), Y.data(), Z.data(), Out.data(), N,
+                                Octaves, 0.6f, 1.9f);
+    for (std::size_t Idx = 0; Idx < N; Idx++) {
+      EXPECT_EQ(Out[Idx], ymir::Simplex::noise3d(X[Idx], Y[Idx], Z[Idx],
+                                                 Octaves, 0.6f, 1.9f))
+          << Idx;
+    }
+  }
+}
+
+TEST(NoiseTest, SimplexNoiseMapParallelAndChunked) {
+  const auto Ref = ymir::Simplex::generateNoiseMap<int>(
+      {203, 67}, {-50, 13}, 3, 16.0f, 4, 0.5f, 2.0f);
+  ymir::ThreadPoolExecutor Pool(3);
+  EXPECT_MAP_EQ(ymir::Simplex::generateNoiseMap<int>(Pool, {203, 67}, {-50, 13},
+                                                     3, 16.0f, 4, 0.5f, 2.0f),
+                Ref);
+
+  // Fill a larger map chunk by chunk, each chunk at its world position
+  ymir::Map<float, int> M(213, 77);
+  const ymir::Point2d<int> Pos{4, 6};
+  for (int Y = 0; Y < 67; Y += 32) {
+    for (int X = 0; X < 203; X += 50) {
+      const ymir::Point2d<int> Chunk{X, Y};
+      auto View = M.view(ymir::Rect2d<int>{Chunk + Pos, {50, 32}});
+      ymir::Simplex::fillNoise(View, Chunk + ymir::Point2d<int>{-50, 13}, 3,
+                               16.0f, 4, 0.5f, 2.0f);
+    }
+  }
+  EXPECT_MAP_EQ(M.view(ymir::Rect2d<int>{Pos, Ref.getSize()}).toMap(), Ref);
+}
+
+TEST(NoiseTest, SeededSimplexNoise) {
+  const std::size_t N = 301;
+  std::mt19937 RndEng(7);
+  std::uniform_real_distribution<float> Dist(-100.0f, 100.0f);
+  std::vector<float> X(N), Y(N), Z(N), Out(N);
+  for (std::size_t Idx = 0; Idx < N; Idx++) {
+    X[Idx] = Dist(RndEng);
+    Y[Idx] = Dist(RndEng);
+    Z[Idx] = Idx % 4 == 0 ? std::floor(Dist(RndEng)) : Dist(RndEng);
+  }
+  const ymir::Simplex::SeededNoise Noise(42), Same(42), Other(43);
+  Noise.noise2dBatch(X.data(), Y.data(), Out.data(), N, 3);
+  std::size_t Differing = 0;
+  for (std::size_t Idx = 0; Idx < N; Idx++) {
+    EXPECT_EQ(Out[Idx], Noise.noise2d(X[Idx], Y[Idx], 3)) << Idx;
+    EXPECT_EQ(Out[Idx], Same.noise2d(X[Idx], Y[Idx], 3)) << Idx;
+    Differing += Out[Idx] != Other.noise2d(X[Idx], Y[Idx], 3);
+  }
+  EXPECT_GT(Differing, N / 2);
+  Noise.noise3dBatch(X.data(), Y.data(), Z.data(), Out.data(), N, 2, 0.6f);
+  for (std::size_t Idx = 0; Idx < N; Idx++) {
+    EXPECT_EQ(Out[Idx], Noise.noise3d(X[Idx], Y[Idx], Z[Idx], 2, 0.6f)) << Idx;
+  }
+
+  ymir::Map<float, int> M(37, 21), Ref(37, 21);
+  ymir::ThreadPoolExecutor Pool(2);
+  ymir::Simplex::fillNoise(Pool, Noise, M.view(), {-5, 9}, 8.0f, 4);
+  Ref.forEach([&Noise](ymir::Point2d<int> P, float &Tile) {
+    Tile = Noise.noise2d(float(P.X - 5) / 8.0f, float(P.Y + 9) / 8.0f, 4);
+  });
+  EXPECT_MAP_EQ(M, Ref);
+}
+
+TEST(NoiseTest, CoordHashRows) {
+  const ymir::CoordHash Hash(5);
+  // Rows crossing zero and the wrap around of the 32 bit coordinates
+  for (const std::int64_t X : {-21ll, 0ll, 4294967290ll}) {
+    for (const std::size_t N : {0, 3, 8, 43}) {
+      std::vector<std::uint32_t> Row(N);
+      Hash.fillRow(X, -7, Row.data(), N);
+      for (std::size_t Idx = 0; Idx < N; Idx++) {
+        EXPECT_EQ(Row[Idx], Hash(X + std::int64_t(Idx), -7))
+            << X << " " << Idx;
+      }
+    }
+  }
+  // Mirrored coordinates and other seeds do not repeat the values
+  const ymir::CoordHash Other(6);
+  std::size_t Same = 0;
+  for (int Y = 0; Y < 32; Y++) {
+    for (int X = 0; X < 32; X++) {
+      Same += X != Y && Hash(X, Y) == Hash(Y, X);
+      Same += Hash(X, Y) == Other(X, Y);
+    }
+  }
+  EXPECT_EQ(Same, 0u);
+}
+
+TEST(NoiseTest, FillRectCoordRandom) {
+  const ymir::CoordHash Hash(11);
+  ymir::Map<char, int> M(203, 61), Ref(203, 61);
+  M.fill('#');
+  Ref.fill('#');
+  const ymir::Point2d<int> Offset{-90, 40};
+  ymir::fillRectCoordRandom(M, ' ', 0.4f, Hash, {}, Offset);
+  Ref.forEach([&Hash, Offset](ymir::Point2d<int> P, char &Tile) {
+    if (Hash(P.X + Offset.X, P.Y + Offset.Y) < 0.4 * 4294967296.0) {
+      Tile = ' ';
+    }
+  });
+  EXPECT_MAP_EQ(M, Ref);
+  EXPECT_NEAR(double(countTiles(M, ' ')) / (203 * 61), 0.4, 0.02);
+
+  // Chunks filled at their world position give the same map
+  ymir::Map<char, int> Chunked(203, 61);
+  Chunked.fill('#');
+  for (int Y = 0; Y < 61; Y += 16) {
+    for (int X = 0; X < 203; X += 32) {
+      ymir::Map<char, int> Chunk(std::min(32, 203 - X), std::min(16, 61 - Y));
+      Chunk.fill('#');
+      const ymir::Point2d<int> Pos{X, Y};
+      ymir::fillRectCoordRandom(Chunk, ' ', 0.4f, Hash, {}, Offset + Pos);
+      Chunked.merge(Chunk, Pos);
+    }
+  }
+  EXPECT_MAP_EQ(Chunked, M);
+
+  ymir::fillRectCoordRandom(M, '.', 1.0f, Hash,
+                            ymir::Rect2d<int>{{3, 4}, {5, 6}});
+  EXPECT_EQ(countTiles(M, '.'), 30u);
+  ymir::fillRectCoordRandom(M, '+', 0.0f, Hash);
+  EXPECT_EQ(countTiles(M, '+'), 0u);
+}
+
+TEST(NoiseTest, BernoulliBits) {
+  // Engine counting its calls
+  struct CountingRndEng : ymir::WyHashRndEng {
+    ymir::Uint64 operator()() {
+      Calls++;
+      return ymir::WyHashRndEng::operator()();
+    }
+    std::size_t Calls = 0;
+  };
+  const std::size_t Words = 2000;
+  for (const float Chance : {0.0f, 0.25f, 0.5f, 0.55f, 0.85f, 1.0f}) {
+    CountingRndEng RndEng;
+    RndEng.seed(17);
+    const ymir::BernoulliBits Bernoulli(Chance);
+    std::size_t Count = 0;
+    for (std::size_t Idx = 0; Idx < Words; Idx++) {
+      Count += ymir::popCount(Bernoulli(RndEng));
+    }
+    EXPECT_NEAR(double(Count) / (Words * 64), Chance, 0.005) << Chance;
+    EXPECT_LE(RndEng.Calls, Words * 10) << Chance;
+  }
+  std::mt19937 RndEng(3);
+  const ymir::BernoulliBits Quarter(0.25f);
+  for (int Idx = 0; Idx < 8; Idx++) {
+    EXPECT_NE(Quarter(RndEng), Quarter(RndEng));
+  }
+}
+
+TEST(NoiseTest, FillRectRandomBitMap) {
+  // Rows starting at a word boundary draw the same bits for both maps
+  const ymir::Rect2d<int> Rect{{0, 2}, {150, 30}};
+  ymir::Map<char, int> M(157, 37);
+  M.fill('#');
+  std::mt19937 RndEng(23);
+  ymir::fillRectRandom(M, ' ', 0.6f, RndEng, Rect);
+  ymir::BitMap<int> BM(157, 37);
+  RndEng.seed(23);
+  ymir::fillRectRandom(BM, true, 0.6f, RndEng, Rect);
+  EXPECT_EQ(BM, ymir::BitMap<int>::fromMap(M, ' '));
+  EXPECT_NEAR(double(BM.count()) / (150 * 30), 0.6, 0.03);
+
+  BM.fill(true);
+  ymir::fillRectRandom(BM, false, 0.3f, RndEng,
+                       ymir::Rect2d<int>{{60, 1}, {10, 2}});
+  BM.flip();
+  BM.fillRect(false, ymir::Rect2d<int>{{60, 1}, {10, 2}});
+  EXPECT_EQ(BM.count(), 0u);
+}
+
+TEST(NoiseTest, FillRectRandomBoolMap) {
+  // Bool tiles are not addressable, they are set one by one from the same bits
+  const ymir::Rect2d<int> Rect{{3, 1}, {90, 20}};
+  ymir::Map<char, int> M(97, 23);
+  M.fill('#');
+  std::mt19937 RndEng(5);
+  ymir::fillRectRandom(M, ' ', 0.4f, RndEng, Rect);
+  ymir::Map<bool, int> BoolMap(97, 23);
+  BoolMap.fill(false);
+  RndEng.seed(5);
+  ymir::fillRectRandom(BoolMap, true, 0.4f, RndEng, Rect);
+  M.forEach([&BoolMap](auto Pos, char Tile) {
+    EXPECT_EQ(BoolMap.getTile(Pos), Tile == ' ') << Pos;
+  });
+
+  // Same for the coordinate hash
+  const ymir::CoordHash Hash(17);
+  M.fill('#');
+  ymir::fillRectCoordRandom(M, ' ', 0.4f, Hash, Rect, {5, -8});
+  BoolMap.fill(false);
+  ymir::fillRectCoordRandom(BoolMap, true, 0.4f, Hash, Rect, {5, -8});
+  M.forEach([&BoolMap](auto Pos, char Tile) {
+    EXPECT_EQ(BoolMap.getTile(Pos), Tile == ' ') << Pos;
+  });
+}
+
+TEST(NoiseTest, WyHashRndEngStreams) {
+  ymir::WyHashRndEng RndEng, Ref;
+  RndEng.seed(99);
+  Ref.seed(99);
+  // Lengths with and without a remainder of the four values per iteration
+  for (const std::size_t N : {0, 1, 7, 64}) {
+    std::vector<ymir::Uint64> Values(N);
+    RndEng.fill(Values.data(), N);
+    for (std::size_t Idx = 0; Idx < N; Idx++) {
+      EXPECT_EQ(Values[Idx], Ref()) << N << " " << Idx;
+    }
+  }
+  RndEng.discard(1000);
+  for (int Idx = 0; Idx < 1000; Idx++) {
+    Ref();
+  }
+  EXPECT_EQ(RndEng(), Ref());
+
+  // Sub-streams are reproducible, distinct and leave the engine as is
+  auto First = RndEng.split(0), Second = RndEng.split(1);
+  auto FirstAgain = RndEng.split(0);
+  EXPECT_EQ(RndEng(), Ref());
+  std::vector<ymir::Uint64> Drawn;
+  for (int Idx = 0; Idx < 100; Idx++) {
+    const auto Value = First();
+    EXPECT_EQ(Value, FirstAgain());
+    Drawn.push_back(Value);
+    Drawn.push_back(Second());
+    Drawn.push_back(Ref());
+  }
+  std::sort(Drawn.begin(), Drawn.end());
+  EXPECT_EQ(std::unique(Drawn.begin(), Drawn.end()), Drawn.end());
+
+  // Nested splits depend on their order and splits of an advanced engine are
+  // no shifted copies of earlier splits with the same id
+  auto OneTwo = RndEng.split(1).split(2), TwoOne = RndEng.split(2).split(1);
+  auto Early = RndEng.split(0);
+  RndEng.discard(10);
+  auto Late = RndEng.split(0);
+  Early.discard(10);
+  std::vector<ymir::Uint64> Streams;
+  for (auto *Eng : {&OneTwo, &TwoOne, &Early, &Late}) {
+    for (int Idx = 0; Idx < 100; Idx++) {
+      Streams.push_back((*Eng)());
+    }
+  }
+  std::sort(Streams.begin(), Streams.end());
+  EXPECT_EQ(std::unique(Streams.begin(), Streams.end()), Streams.end());
+}
+
+TEST(NoiseTest, PortableSamplers) {
+  ymir::WyHashRndEng RndEng;
+  RndEng.seed(2024);
+  // Fixed values, the samplers must give them with every standard library
+  EXPECT_EQ(ymir::randomBounded(RndEng, 6), 2u);
+  EXPECT_EQ(ymir::randomInt(RndEng, -10, 10), 0);
+  EXPECT_EQ(ymir::randomFloat(RndEng), 0x1.11ef4cp-2f);
+  std::minstd_rand0 MinStd(7);
+  EXPECT_EQ(ymir::randomBounded(MinStd, 1000), 36u);
+
+  std::vector<int> Counts(7);
+  for (int Idx = 0; Idx < 70000; Idx++) {
+    const auto Value = ymir::randomInt(RndEng, 3, 9);
+    ASSERT_GE(Value, 3);
+    ASSERT_LE(Value, 9);
+    Counts[Value - 3]++;
+  }
+  for (const auto Count : Counts) {
+    EXPECT_NEAR(Count, 10000, 400);
+  }
+  EXPECT_EQ(ymir::randomInt<unsigned>(RndEng, 5, 5), 5u);
+  ymir::randomInt(RndEng, std::numeric_limits<ymir::Uint64>::min(),
+                  std::numeric_limits<ymir::Uint64>::max());
+  for (int Idx = 0; Idx < 1000; Idx++) {
+    const auto Value = ymir::randomFloat(RndEng, -2.0f, 3.0f);
+    ASSERT_GE(Value, -2.0f);
+    ASSERT_LT(Value, 3.0f);
+  }
+}
+
+template <typename RE> void checkBatchSamplers(RE RndEng) {
+  auto Ref = RndEng;
+  std::vector<int> Ints(150);
+  ymir::fillRandomInt(RndEng, -3, 1000, Ints.data(), Ints.size());
+  for (const auto Value : Ints) {
+    EXPECT_EQ(Value, ymir::randomInt(Ref, -3, 1000));
+  }
+  std::vector<float> Floats(77);
+  ymir::fillRandomFloat(RndEng, Floats.data(), Floats.size());
+  for (const auto Value : Floats) {
+    EXPECT_EQ(Value, ymir::randomFloat(Ref));
+  }
+  std::vector<int> Shuffled(50);
+  std::iota(Shuffled.begin(), Shuffled.end(), 0);
+  ymir::randomShuffle(Shuffled.begin(), Shuffled.end(), RndEng);
+  auto Sorted = Shuffled;
+  std::sort(Sorted.begin(), Sorted.end());
+  EXPECT_NE(Shuffled, Sorted);
+  for (int Idx = 0; Idx < 50; Idx++) {
+    EXPECT_EQ(Sorted[Idx], Idx);
+  }
+}
 
+TEST(NoiseTest, BatchSamplers) {
+  ymir::WyHashRndEng WyHash;
+  WyHash.seed(8);
+  checkBatchSamplers(WyHash);
+  checkBatchSamplers(std::mt19937(8));
+}
 
-} // namespace
\ No newline at end of file
+} // namespace
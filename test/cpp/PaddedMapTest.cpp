@@ -0,0 +1,108 @@
+#include "TestHelpers.hpp"
+#include <gtest/gtest.h>
+#include <ymir/CallularAutomata.hpp>
+#include <ymir/Map.hpp>
+#include <ymir/MapFilter.hpp>
+#include <ymir/MapIo.hpp>
+#include <ymir/PaddedMap.hpp>
+
+namespace {
+
+TEST(PaddedMapTest, Construct) {
+  auto Map = ymir::loadMap({
+      "# #",
+      "#x#",
+      "###",
+  });
+  ymir::PaddedMap<char, int, 2> PM(Map, '?');
+  EXPECT_EQ(PM.getSize(), Map.getSize());
+  EXPECT_EQ(PM.getPaddedMap().getSize(), ymir::Size2d<int>(7, 7));
+  EXPECT_EQ(PM.paddedRect(), ymir::Rect2d<int>({-2, -2}, {7, 7}));
+  EXPECT_EQ(PM.getTile({1, 1}), 'x');
+  EXPECT_EQ(PM.getTileUnchecked({-2, -2}), '?');
+  EXPECT_EQ(PM.getTileUnchecked({3, 1}), '?');
+  EXPECT_THROW(PM.getTile({3, 1}), std::out_of_range);
+  EXPECT_MAP_EQ(PM.toMap(), Map);
+
+  PM.setSentinel('!');
+  EXPECT_EQ(PM.getTileUnchecked({-1, 0}), '!');
+  EXPECT_MAP_EQ(PM.toMap(), Map);
+
+  PM.fill('.');
+  EXPECT_EQ(PM.getTileUnchecked({-1, 0}), '!');
+  EXPECT_EQ(PM.getTile({2, 2}), '.');
+
+  PM.setTileUnchecked({-2, 4}, '+');
+  EXPECT_EQ(PM.getTileUnchecked({-2, 4}), '+');
+  PM.setSentinel('!');
+  EXPECT_EQ(PM.getTileUnchecked({-2, 4}), '!');
+}
+
+TEST(PaddedMapTest, EqualityIgnoresHalo) {
+  ymir::PaddedMap<char, int> PM(3, 2, '?'), Other(3, 2, '!'), Tall(2, 3, '?');
+  PM.fill('.');
+  Other.fill('.');
+  EXPECT_TRUE(PM == Other);
+  Other.setTile({2, 1}, '#');
+  EXPECT_FALSE(PM == Other);
+  EXPECT_FALSE(PM == Tall);
+}
+
+TEST(PaddedMapTest, NeighborCount) {
+  auto Map = ymir::loadMap({
+      "# #",
+      "#x#",
+      "###",
+  });
+  ymir::PaddedMap<char, int> PM(Map, ' ');
+  EXPECT_EQ(PM.getNeighborCount({1, 1}, '#'), 7);
+  EXPECT_EQ(PM.getNeighborCount({0, 0}, '#'), 1);
+  EXPECT_EQ(PM.getNeighborCount({0, 0}, ' '), 6);
+  EXPECT_EQ(PM.getNotNeighborCount({0, 0}, '#'), 7);
+  EXPECT_EQ(PM.getNeighborCount({1, 0}, '#', ymir::FourTileDirections<int>()),
+            2);
+
+  std::vector<ymir::Point2d<int>> Neighbors;
+  PM.checkNeighbors(
+      {0, 0},
+      [&Neighbors](auto Pos, char) {
+        Neighbors.push_back(Pos);
+        return true;
+      },
+      ymir::FourTileDirections<int>());
+  EXPECT_EQ(Neighbors, (std::vector<ymir::Point2d<int>>{
+                           {-1, 0}, {1, 0}, {0, -1}, {0, 1}}));
+}
+
+TEST(PaddedMapTest, EdgeFilters) {
+  auto Map = ymir::loadMap({
+      "#####",
+      "#   #",
+      "#   #",
+      "#####",
+  });
+  ymir::PaddedMap<char, int> PM(Map, '#');
+  Map.forEach([&PM, &Map](auto Pos, char) {
+    EXPECT_EQ(ymir::verticalEdgeFilter(PM, Pos, ' '),
+              ymir::verticalEdgeFilter(Map, Pos, ' '))
+        << Pos;
+    EXPECT_EQ(ymir::horizontalEdgeFilter(PM, Pos, ' '),
+              ymir::horizontalEdgeFilter(Map, Pos, ' '))
+        << Pos;
+  });
+}
+
+TEST(PaddedMapTest, CellularAutomataMatchesMap) {
+  auto Map = makeRandomMap({40, 20}, 42, 0.65f);
+  ymir::PaddedMap<char, int> PM(Map, '?');
+
+  for (int Idx = 0; Idx < 4; Idx++) {
+    ymir::celat::replace(Map, ' ', '#', 4);
+    ymir::celat::replace(PM, ' ', '#', 4);
+  }
+  ymir::celat::generate(Map, ' ', 5);
+  ymir::celat::generate(PM, ' ', 5);
+  EXPECT_MAP_EQ(PM.toMap(), Map);
+}
+
+} // namespace
@@ -0,0 +1,58 @@
+#include "TestHelpers.hpp"
+#include <gtest/gtest.h>
+#include <ymir/Map.hpp>
+#include <ymir/MapIo.hpp>
+#include <ymir/SummedAreaTable.hpp>
+
+namespace {
+
+TEST(SummedAreaTableTest, Count) {
+  auto M = ymir::loadMap({
+      "#####",
+      "#  ##",
+      "#####",
+  });
+  auto SAT = ymir::SummedAreaTable<int>::fromTile(M, '#');
+  EXPECT_EQ(SAT.getSize(), M.getSize());
+  EXPECT_EQ(SAT.count(M.rect()), 13);
+  EXPECT_EQ(SAT.count({{1, 1}, {2, 1}}), 0);
+  EXPECT_EQ(SAT.count({{1, 0}, {3, 2}}), 4);
+  EXPECT_EQ(SAT.count({{-2, -2}, {3, 3}}), 1);
+  EXPECT_EQ(SAT.count({{5, 0}, {1, 1}}), 0);
+  EXPECT_TRUE(SAT.isSet({0, 0}));
+  EXPECT_FALSE(SAT.isSet({1, 1}));
+  EXPECT_FALSE(SAT.isSet({-1, 0}));
+  EXPECT_EQ(SAT.getWindowCount({2, 1}, 1), 7);
+  EXPECT_EQ(SAT.getWindowCount({2, 1}, 2), 13);
+}
+
+TEST(SummedAreaTableTest, MatchesMapNeighborCount) {
+  auto M = makeRandomMap({37, 23}, 7, 0.45f);
+
+  const auto SAT = ymir::SummedAreaTable<int>::fromTile(M, '#');
+  const auto Counts = ymir::getNeighborCountMap(M, '#');
+  const auto Counts4 =
+      ymir::getNeighborCountMap<ymir::FourTileDirections<int>>(M, '#');
+  M.forEach([&](ymir::Point2d<int> P, char) {
+    const auto Exp8 = M.getNeighborCount(P, '#');
+    const auto Exp4 =
+        M.getNeighborCount(P, '#', ymir::FourTileDirections<int>());
+    EXPECT_EQ(SAT.getNeighborCount(P), Exp8) << P;
+    EXPECT_EQ(SAT.getNeighborCount(P, ymir::FourTileDirections<int>()), Exp4)
+        << P;
+    EXPECT_EQ(SAT.getNotNeighborCount(P), 8 - Exp8) << P;
+    EXPECT_EQ(static_cast<std::size_t>(Counts.getTile(P)), Exp8) << P;
+    EXPECT_EQ(static_cast<std::size_t>(Counts4.getTile(P)), Exp4) << P;
+
+    std::size_t Window = 0;
+    for (int DY = -2; DY <= 2; DY++) {
+      for (int DX = -2; DX <= 2; DX++) {
+        const ymir::Point2d<int> Q{P.X + DX, P.Y + DY};
+        Window += (DX != 0 || DY != 0) && M.contains(Q) && M.getTile(Q) == '#';
+      }
+    }
+    EXPECT_EQ(SAT.getWindowCount(P, 2), Window) << P;
+  });
+}
+
+} // namespace
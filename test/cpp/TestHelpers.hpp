@@ -2,6 +2,7 @@
 #define YMIR_TEST_HELPERS_HPP
 
 #include <algorithm>
+#include <random>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -9,6 +10,7 @@
 #include <ymir/Dungeon/Room.hpp>
 #include <ymir/Map.hpp>
 #include <ymir/MapIo.hpp>
+#include <ymir/Noise.hpp>
 
 namespace {
 
@@ -78,6 +80,16 @@ getRoom(const std::vector<std::string> &RoomRepr) {
   return R;
 }
 
+/// Wall map with each tile cleared to ' ' with the given chance
+[[maybe_unused]] ymir::Map<char, int>
+makeRandomMap(ymir::Size2d<int> Size, unsigned Seed, float Chance) {
+  ymir::Map<char, int> M(Size);
+  M.fill('#');
+  std::mt19937 RndEng(Seed);
+  ymir::fillRectRandom(M, ' ', Chance, RndEng);
+  return M;
+}
+
 #define EXPECT_MAP_EQ(Map, MapRef)                                             \
   EXPECT_EQ(Map, MapRef) << "Map:\n" << Map << "\nMap Ref:\n" << MapRef << "\n";
 
@@ -0,0 +1,96 @@
+#include "TestHelpers.hpp"
+#include <gtest/gtest.h>
+#include <set>
+#include <ymir/Map.hpp>
+#include <ymir/MapFilter.hpp>
+#include <ymir/TiledMap.hpp>
+
+namespace {
+
+template <typename Layout> class TiledMapTest : public testing::Test {};
+
+using Layouts = testing::Types<ymir::BlockLayout<4>, ymir::BlockLayout<16>,
+                               ymir::MortonLayout>;
+TYPED_TEST_SUITE(TiledMapTest, Layouts, );
+
+TYPED_TEST(TiledMapTest, ConvertMap) {
+  auto Map = makeRandomMap({13, 7}, 42, 0.5f);
+  ymir::TiledMap<char, int, TypeParam> TM(Map);
+  EXPECT_EQ(TM.getSize(), Map.getSize());
+  EXPECT_MAP_EQ(TM.toMap(), Map);
+  Map.forEach([&TM](auto Pos, char Tile) {
+    EXPECT_EQ(TM.getTile(Pos), Tile) << Pos;
+    EXPECT_TRUE(TM.isTile(Pos, Tile)) << Pos;
+  });
+  EXPECT_THROW(TM.getTile({13, 0}), std::out_of_range);
+  EXPECT_THROW(TM.getTile({0, -1}), std::out_of_range);
+  EXPECT_FALSE(TM.isTile({13, 0}, '#'));
+
+  TM.setTile({12, 6}, 'x');
+  Map.setTile({12, 6}, 'x');
+  EXPECT_MAP_EQ(TM.toMap(), Map);
+  EXPECT_EQ(TM.findTiles('x'), (std::vector<ymir::Point2d<int>>{{12, 6}}));
+}
+
+TYPED_TEST(TiledMapTest, ForEachFollowsStorageOrder) {
+  ymir::TiledMap<char, int, TypeParam> TM(21, 11);
+  std::size_t Count = 0, LastIdx = 0;
+  TM.forEach([&](auto Pos, char &) {
+    const auto Idx = TM.index(Pos);
+    if (Count++ > 0) {
+      EXPECT_GT(Idx, LastIdx) << Pos;
+    }
+    LastIdx = Idx;
+  });
+  EXPECT_EQ(Count, 21 * 11);
+
+  const ymir::Rect2d<int> Rect{{3, 2}, {15, 6}};
+  std::set<ymir::Point2d<int>> Visited;
+  TM.forEach([&Visited](auto Pos, const char &) { Visited.insert(Pos); },
+             Rect);
+  EXPECT_EQ(Visited.size(), 15 * 6);
+  for (const auto &Pos : Visited) {
+    EXPECT_TRUE(Rect.contains(Pos)) << Pos;
+  }
+
+  TM.fill(' ');
+  TM.fillRect('#', Rect);
+  ymir::Map<char, int> Map(21, 11);
+  Map.fill(' ');
+  Map.fillRect('#', Rect);
+  EXPECT_MAP_EQ(TM.toMap(), Map);
+}
+
+TYPED_TEST(TiledMapTest, EqualityIgnoresPadding) {
+  // 13x7 leaves padding tiles in the last blocks of every layout
+  ymir::TiledMap<char, int, TypeParam> Filled(13, 7), Set(13, 7);
+  Filled.fill('#');
+  Set.forEach([](auto, char &Tile) { Tile = '#'; });
+  EXPECT_TRUE(Filled == Set);
+  Set.setTile({12, 6}, ' ');
+  EXPECT_FALSE(Filled == Set);
+  EXPECT_FALSE(Filled == (ymir::TiledMap<char, int, TypeParam>(7, 13)));
+}
+
+TYPED_TEST(TiledMapTest, NeighborsMatchMap) {
+  auto Map = makeRandomMap({37, 19}, 42, 0.5f);
+  ymir::TiledMap<char, int, TypeParam> TM(Map);
+  Map.forEach([&TM, &Map](auto Pos, char) {
+    EXPECT_EQ(TM.getNeighborCount(Pos, '#'), Map.getNeighborCount(Pos, '#'))
+        << Pos;
+    EXPECT_EQ(TM.getNeighborCount(Pos, ' ', ymir::FourTileDirections<int>()),
+              Map.getNeighborCount(Pos, ' ', ymir::FourTileDirections<int>()))
+        << Pos;
+  });
+
+  // Map::isTile wraps X into the neighboring rows, compare interior columns only
+  Map.forEach(
+      [&TM, &Map](auto Pos, char) {
+        EXPECT_EQ(ymir::verticalEdgeFilter(TM, Pos, ' '),
+                  ymir::verticalEdgeFilter(Map, Pos, ' '))
+            << Pos;
+      },
+      ymir::Rect2d<int>{{1, 0}, {35, 19}});
+}
+
+} // namespace